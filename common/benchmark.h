@@ -0,0 +1,460 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#ifdef __linux__
+#include <sched.h>
+#include <unistd.h>
+#endif
+
+
+struct BenchmarkResult
+{
+    std::string name;       // name of the benchmarked function
+    long size;              // problem size, e.g., number of grid points
+    int repetitions;        // number of timed repetitions
+    int outliers;           // repetitions further than 3 MAD from the median
+    double median;          // seconds
+    double min;             // seconds
+    double mean;            // seconds
+    double mad;             // median absolute deviation, seconds
+    double ci_low;          // 95% confidence interval of the median, seconds
+    double ci_high;
+    double gflops;          // 1e9 floating point operations per second at median
+    double gbytes;          // 1e9 bytes per second at median
+    double cpu_mhz;         // frequency of the current core after the run
+    int cpu;                // core the last repetition ran on
+};
+
+
+class Benchmark
+{
+    /*
+    Benchmark harness shared by all the projects. Include it with
+    #include "../../common/benchmark.h".
+
+    Every call to run does a number of untimed warm-up calls, and then times
+    the function until the 95% confidence interval of the median is within
+    rel_ci of the median, or until max_repetitions or max_time is reached.
+    max_time is wall-clock time from the start of run, so it also bounds
+    the setup the functions exclude from their timing, but min_repetitions
+    are always done. With set_core, the calling thread is pinned to one core
+    during run, and its previous affinity is restored afterwards.
+    The median, minimum, median absolute deviation (MAD) and number of
+    outliers are reported together with the throughput in GFLOP/s and GB/s,
+    the frequency of the core and the affinity of the process, and can be
+    written as CSV or JSON.
+
+    The function to benchmark is called without arguments. If it returns a
+    double, the return value is taken as the measured time in seconds, which
+    is how the solvers in this repository exclude their setup from the
+    timing. Otherwise the whole call is timed.
+    */
+private:
+    int warmup          = 2;     // untimed calls before timing
+    int min_repetitions = 10;
+    int max_repetitions = 1000;
+    double max_time     = 10;    // wall-clock seconds per run
+    double rel_ci       = 0.01;  // target relative half-width of the CI
+    bool progress       = true;  // toggling progress info on/off
+    int core            = -1;    // core to pin run to, -1 for no pinning
+
+    double percentile_sorted(const std::vector<double>& sorted, double q)
+    {   /*
+        Linear interpolation between the order statistics of sorted data.
+        */
+        double pos = q*(sorted.size() - 1);
+        int low    = (int)std::floor(pos);
+        int high   = std::min(low + 1, (int)sorted.size() - 1);
+        return sorted[low] + (pos - low)*(sorted[high] - sorted[low]);
+    }
+
+    void median_ci(const std::vector<double>& sorted, double& low, double& high)
+    {   /*
+        Distribution free 95% confidence interval of the median, from the
+        order statistics k/2 -+ 1.96*sqrt(k)/2.
+        */
+        int k = sorted.size();
+        double half = 1.96*std::sqrt((double)k)/2;
+        int lower = std::max(0, (int)std::floor(k/2.0 - half));
+        int upper = std::min(k - 1, (int)std::ceil(k/2.0 + half));
+        low  = sorted[lower];
+        high = sorted[upper];
+    }
+
+public:
+    std::vector<BenchmarkResult> results;
+
+    Benchmark()
+    {
+
+    }
+
+    void set_repetitions(int warmup_input, int min_input, int max_input)
+    {   /*
+        Parameters
+        ----------
+        warmup_input : int
+            Number of untimed warm-up calls.
+
+        min_input : int
+            Minimum number of timed calls.
+
+        max_input : int
+            Maximum number of timed calls.
+        */
+        warmup          = warmup_input;
+        min_repetitions = std::max(1, min_input);
+        max_repetitions = std::max(min_repetitions, max_input);
+    }
+
+    void set_stop_criteria(double rel_ci_input, double max_time_input)
+    {   /*
+        Parameters
+        ----------
+        rel_ci_input : double
+            Target half-width of the confidence interval of the median,
+            relative to the median.
+
+        max_time_input : double
+            Upper limit in wall-clock seconds for one run, including warm-up
+            and untimed setup.
+        */
+        rel_ci   = rel_ci_input;
+        max_time = max_time_input;
+    }
+
+    void set_progress(bool progress_input)
+    {
+        progress = progress_input;
+    }
+
+    void set_core(int core_input)
+    {   /*
+        Pins every run to one core, see pin_to_core. Off by default.
+
+        Parameters
+        ----------
+        core_input : int
+            Index of the core, or -1 for no pinning.
+        */
+        core = core_input;
+    }
+
+    static bool pin_to_core(int core)
+    {   /*
+        Pins the calling thread to one core, so that repetitions are not
+        moved between cores. Returns false if pinning is not supported.
+
+        Parameters
+        ----------
+        core : int
+            Index of the core.
+        */
+        #ifdef __linux__
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(core, &set);
+        return sched_setaffinity(0, sizeof(set), &set) == 0;
+        #else
+        (void)core;
+        return false;
+        #endif
+    }
+
+    static int current_cpu()
+    {
+        #ifdef __linux__
+        return sched_getcpu();
+        #else
+        return -1;
+        #endif
+    }
+
+    static std::string affinity()
+    {   /*
+        The cores the process may run on, e.g., "0,1,2,3".
+        */
+        std::string cores;
+        #ifdef __linux__
+        cpu_set_t set;
+        CPU_ZERO(&set);
+
+        if (sched_getaffinity(0, sizeof(set), &set) == 0)
+        {
+            for (int i=0; i<CPU_SETSIZE; i++)
+            {
+                if (CPU_ISSET(i, &set))
+                {
+                    cores += (cores.empty() ? "" : ",") + std::to_string(i);
+                }
+            }
+        }
+        #endif
+        return cores;
+    }
+
+    static double cpu_mhz(int cpu)
+    {   /*
+        Current frequency of a core in MHz from cpufreq, or from /proc/cpuinfo
+        if cpufreq is not available. Returns 0 if neither can be read.
+
+        Parameters
+        ----------
+        cpu : int
+            Index of the core.
+        */
+        double khz = 0;
+        std::ifstream freq_file("/sys/devices/system/cpu/cpu" + std::to_string(cpu)
+            + "/cpufreq/scaling_cur_freq");
+
+        if (freq_file >> khz)
+        {
+            return khz/1000;
+        }
+
+        std::ifstream cpuinfo("/proc/cpuinfo");
+        std::string line;
+        int processor = -1;
+        double mhz = 0;
+
+        while (std::getline(cpuinfo, line))
+        {   // finding the 'cpu MHz' entry of the requested processor
+            if (line.rfind("processor", 0) == 0)
+            {
+                processor = std::stoi(line.substr(line.find(':') + 1));
+            }
+            else if (line.rfind("cpu MHz", 0) == 0)
+            {
+                mhz = std::stod(line.substr(line.find(':') + 1));
+                if ((processor == cpu) || (cpu < 0))
+                {
+                    return mhz;
+                }
+            }
+        }
+        return mhz;
+    }
+
+    template <class F>
+    BenchmarkResult run(std::string name, long size, double flops, double bytes,
+        F func)
+    {   /*
+        Benchmarks one function and stores the result.
+
+        Parameters
+        ----------
+        name : std::string
+            Name of the benchmark.
+
+        size : long
+            Problem size, only used for reporting.
+
+        flops : double
+            Floating point operations per call. Use 0 if unknown.
+
+        bytes : double
+            Bytes moved to and from memory per call. Use 0 if unknown.
+
+        func : callable
+            Function to benchmark, called without arguments. May return the
+            measured time in seconds as a double.
+
+        Returns
+        -------
+        result : BenchmarkResult
+            Statistics of the timed calls.
+        */
+
+        auto timed_call = [&func]()
+        {
+            if constexpr (std::is_same<decltype(func()), double>::value)
+            {
+                return func();
+            }
+            else
+            {
+                std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
+                func();
+                std::chrono::steady_clock::time_point t2 = std::chrono::steady_clock::now();
+                return std::chrono::duration_cast<std::chrono::duration<double> >(t2 - t1).count();
+            }
+        };
+
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+        #ifdef __linux__
+        cpu_set_t previous_affinity;
+        bool pinned = (core >= 0)
+            && (sched_getaffinity(0, sizeof(previous_affinity), &previous_affinity) == 0)
+            && pin_to_core(core);
+        #endif
+
+        for (int i=0; i<warmup; i++)
+        {   // warming up caches, page tables and the frequency governor
+            timed_call();
+        }
+
+        std::vector<double> times;
+        std::vector<double> sorted;
+        double total_time = 0;
+        double ci_low     = 0;
+        double ci_high    = 0;
+
+        while ((int)times.size() < max_repetitions)
+        {   // repeating until the median is known well enough
+            double time = timed_call();
+            times.push_back(time);
+            total_time += time;
+
+            if ((int)times.size() < min_repetitions)
+            {
+                continue;
+            }
+
+            sorted = times;
+            std::sort(sorted.begin(), sorted.end());
+            median_ci(sorted, ci_low, ci_high);
+            double median = percentile_sorted(sorted, 0.5);
+            double wall_time = std::chrono::duration_cast<std::chrono::duration<double> >(
+                std::chrono::steady_clock::now() - start).count();
+
+            if ((ci_high - ci_low)/2 <= rel_ci*median || wall_time >= max_time)
+            {
+                break;
+            }
+        }
+
+        sorted = times;
+        std::sort(sorted.begin(), sorted.end());
+        median_ci(sorted, ci_low, ci_high);
+
+        BenchmarkResult result;
+        result.name        = name;
+        result.size        = size;
+        result.repetitions = times.size();
+        result.median      = percentile_sorted(sorted, 0.5);
+        result.min         = sorted[0];
+        result.mean        = total_time/times.size();
+        result.ci_low      = ci_low;
+        result.ci_high     = ci_high;
+
+        std::vector<double> deviation(times.size());
+        for (std::size_t i=0; i<times.size(); i++)
+        {
+            deviation[i] = std::fabs(times[i] - result.median);
+        }
+        std::sort(deviation.begin(), deviation.end());
+        result.mad = percentile_sorted(deviation, 0.5);
+
+        result.outliers = 0;
+        for (std::size_t i=0; i<times.size(); i++)
+        {   // 1.4826*MAD estimates the standard deviation for normal data
+            if (deviation[i] > 3*1.4826*result.mad)
+            {
+                result.outliers++;
+            }
+        }
+
+        result.gflops  = (flops > 0) ? flops/result.median/1e9 : 0;
+        result.gbytes  = (bytes > 0) ? bytes/result.median/1e9 : 0;
+        result.cpu     = current_cpu();
+        result.cpu_mhz = cpu_mhz(result.cpu);
+
+        #ifdef __linux__
+        if (pinned)
+        {   // restoring the affinity from before run
+            sched_setaffinity(0, sizeof(previous_affinity), &previous_affinity);
+        }
+        #endif
+
+        if (progress)
+        {
+            std::streamsize precision = std::cout.precision();
+            std::cout << std::setw(30) << name << std::setw(12) << size
+                      << "  median " << std::setprecision(4) << result.median
+                      << " s  +- " << (ci_high - ci_low)/2/result.median*100
+                      << " %  (" << result.repetitions << " runs)" << std::endl;
+            std::cout.precision(precision);
+        }
+
+        results.push_back(result);
+        return result;
+    }
+
+    void write_csv(std::string filename)
+    {   /*
+        Writes all results to a CSV file with a header line. If a file with
+        'filename' already exists, it is overwritten.
+
+        Parameters
+        ----------
+        filename : std::string
+            Filename of output file.
+        */
+        std::ofstream csv_file;
+        csv_file.open(filename);
+        csv_file << "name,size,repetitions,outliers,median,min,mean,mad,"
+                 << "ci_low,ci_high,gflops,gbytes,cpu,cpu_mhz\n";
+        csv_file << std::setprecision(10);
+
+        for (const BenchmarkResult& r : results)
+        {
+            csv_file << r.name << "," << r.size << "," << r.repetitions << ","
+                     << r.outliers << "," << r.median << "," << r.min << ","
+                     << r.mean << "," << r.mad << "," << r.ci_low << ","
+                     << r.ci_high << "," << r.gflops << "," << r.gbytes << ","
+                     << r.cpu << "," << r.cpu_mhz << "\n";
+        }
+        csv_file.close();
+    }
+
+    void write_json(std::string filename)
+    {   /*
+        Writes all results to a JSON file, together with the affinity of the
+        process and the compiler version. If a file with 'filename' already
+        exists, it is overwritten.
+
+        Parameters
+        ----------
+        filename : std::string
+            Filename of output file.
+        */
+        std::ofstream json_file;
+        json_file.open(filename);
+        json_file << std::setprecision(10);
+        json_file << "{\n";
+        json_file << "  \"affinity\": \"" << affinity() << "\",\n";
+        #ifdef __VERSION__
+        json_file << "  \"compiler\": \"" << __VERSION__ << "\",\n";
+        #endif
+        json_file << "  \"results\": [\n";
+
+        for (std::size_t i=0; i<results.size(); i++)
+        {
+            const BenchmarkResult& r = results[i];
+            json_file << "    {\"name\": \"" << r.name << "\", \"size\": " << r.size
+                      << ", \"repetitions\": " << r.repetitions
+                      << ", \"outliers\": " << r.outliers
+                      << ", \"median\": " << r.median << ", \"min\": " << r.min
+                      << ", \"mean\": " << r.mean << ", \"mad\": " << r.mad
+                      << ", \"ci_low\": " << r.ci_low << ", \"ci_high\": " << r.ci_high
+                      << ", \"gflops\": " << r.gflops << ", \"gbytes\": " << r.gbytes
+                      << ", \"cpu\": " << r.cpu << ", \"cpu_mhz\": " << r.cpu_mhz << "}"
+                      << ((i + 1 < results.size()) ? ",\n" : "\n");
+        }
+        json_file << "  ]\n}\n";
+        json_file.close();
+    }
+};
+
+#endif
@@ -6,45 +6,28 @@ import os
 def compare_times():
     """
     Function for plotting and comparing timing values for the different
-    algorithms. Reads data from text file computed by accompanying C++ program.
-    Computes mean values for timings of same grid size and same algorithm, and
-    presents them as a plot.
-    
-    The data file contains three columns. Each column starts with the name of
-    the algorithm, followed by the number of iterations per grid point value,
-    followed by the number of different grid point values tested. Before each
-    block of timing data, the number of grid points for that block of timing
-    data is specified.
+    algorithms. Reads data from compare_times.csv, written by the benchmark
+    harness in the accompanying C++ program. The file contains one line per
+    algorithm and grid size, with the median time, the 95 % confidence
+    interval of the median and the throughput among the columns. The median is
+    plotted with the confidence interval as error bars.
     """
 
-    timing_data = np.loadtxt("compare_times.txt", skiprows=1)
-
-    runs = int(timing_data[0][0])            # number of runs for each grid size value
-    num_grid_values = int(timing_data[1][0]) # number of grid size values
-    timing_data = timing_data[2:]            # slicing away 'runs' and 'num_grid_values'
+    data = np.genfromtxt("compare_times.csv", delimiter=",", names=True,
+        dtype=None, encoding=None)
 
-    thomas      = np.zeros(num_grid_values)
-    thomas_s    = np.zeros(num_grid_values)
-    LU          = np.zeros(num_grid_values)
-    mean_vals   = np.zeros(num_grid_values)
-    grid_values = np.zeros(num_grid_values)
+    for name in dict.fromkeys(data["name"]):
+        # one curve per algorithm, in the order they were benchmarked
+        rows   = data[data["name"] == name]
+        errors = [rows["median"] - rows["ci_low"], rows["ci_high"] - rows["median"]]
+        plt.errorbar(rows["size"], rows["median"], yerr=errors, fmt="-o",
+            capsize=3, label=name)
 
-    for i in range(num_grid_values):
-        # loops over the timing data and calculates mean values
-        tmp = timing_data[i*(runs+1):(i+1)*(runs+1), :]
-        grid_values[i] = int(tmp[0][0])
-        thomas[i], thomas_s[i], LU[i] = np.mean(tmp[1:], axis=0)
-
-    LU[np.where(LU == -1)] = np.nan     # all -1 values are values not computed
-                                        # set to nan so that plot is unaffected
-
-    plt.loglog(grid_values, thomas,   "-o", label="Thomas")
-    plt.loglog(grid_values, thomas_s, "-o", label="Thomas special")
-    plt.loglog(grid_values, LU,       "-o", label="LU")
-    
+    plt.xscale("log")
+    plt.yscale("log")
     plt.ylabel("Seconds")
     plt.xlabel("Grid points")
-    plt.title("Calculation time, mean of 10 runs")
+    plt.title("Calculation time, median with 95 % confidence interval")
     
     plt.legend(loc="best")
     plt.grid()
@@ -52,6 +35,116 @@ def compare_times():
     
     plt.show()
 
+def compare_times_parallel():
+    """
+    Function for plotting the strong scaling of the partitioned Thomas
+    algorithm. Reads data from compare_times_parallel.txt, computed by the
+    accompanying C++ program. Each line contains the grid size, the number of
+    threads, and the timing of the serial and the parallel algorithm. The
+    speedup is relative to the serial Thomas algorithm.
+    """
+
+    n, threads, serial, parallel = \
+        np.loadtxt("compare_times_parallel.txt", skiprows=1, unpack=True)
+
+    fig, ax = plt.subplots(figsize=(10,8))
+
+    for value in np.unique(n):
+        # one curve per grid size
+        idx = n == value
+        thread_values = np.unique(threads[idx])
+        speedup = [np.mean(serial[idx & (threads == t)])/
+            np.mean(parallel[idx & (threads == t)]) for t in thread_values]
+        ax.plot(thread_values, speedup, "-o", label=f"n = {int(value)}")
+
+    ax.plot(thread_values, thread_values, "k--", label="ideal")
+    ax.set_xlabel("Threads")
+    ax.set_ylabel("Speedup")
+    ax.set_title("Strong scaling of the partitioned Thomas algorithm")
+    ax.legend(loc="best")
+    ax.grid()
+
+    plt.tight_layout(pad=2)
+    plt.show()
+
+def compare_times_batched():
+    """
+    Function for plotting the timing of the batched Thomas algorithm against
+    the same number of sequential calls to the general Thomas algorithm. Reads
+    data from compare_times_batched.csv, written by the benchmark harness in
+    the accompanying C++ program. The names are "sequential K=<K>" and
+    "batched K=<K>" for K systems, and the size is the grid size of each
+    system. The median time per system and the speedup of the batched solver
+    are plotted against the grid size, with one curve per batch size.
+    """
+
+    data = np.genfromtxt("compare_times_batched.csv", delimiter=",",
+        names=True, dtype=None, encoding=None)
+
+    layout = np.array([name.split(" K=")[0] for name in data["name"]])
+    batch  = np.array([int(name.split(" K=")[1]) for name in data["name"]])
+
+    fig, (ax0, ax1) = plt.subplots(nrows=2, sharex=True, figsize=(10,8))
+
+    for value in np.unique(batch):
+        # one curve per batch size
+        sequential = data[(batch == value) & (layout == "sequential")]
+        batched    = data[(batch == value) & (layout == "batched")]
+        ax0.loglog(batched["size"], batched["median"]/value, "-o",
+            label=f"K = {value}")
+        ax1.semilogx(batched["size"], sequential["median"]/batched["median"],
+            "-o", label=f"K = {value}")
+
+    ax0.set_ylabel("Seconds per system")
+    ax0.set_title("Batched calculation time, median")
+    ax0.legend(loc="best")
+    ax0.grid()
+
+    ax1.set_xlabel("Grid points")
+    ax1.set_ylabel("Speedup over sequential")
+    ax1.legend(loc="best")
+    ax1.grid()
+
+    plt.tight_layout(pad=2)
+    plt.show()
+
+def compare_mixed_precision():
+    """
+    Function for plotting time and accuracy of the double precision Thomas
+    algorithm against the mixed precision solver. Reads data from
+    compare_mixed_precision.txt, computed by the accompanying C++ program.
+    Each line contains the grid size, the time and max relative error of both
+    solvers, and the number of refinement steps of the mixed precision solver.
+    """
+
+    n, double_time, double_error, mixed_time, mixed_error, refinements = \
+        np.loadtxt("compare_mixed_precision.txt", skiprows=1, unpack=True)
+
+    fig, (ax0, ax1) = plt.subplots(ncols=2, figsize=(14,6))
+
+    ax0.loglog(n, double_time, "-o", label="Double")
+    ax0.loglog(n, mixed_time,  "-o", label="Mixed")
+    ax0.set_xlabel("Grid points")
+    ax0.set_ylabel("Seconds")
+    ax0.set_title("Calculation time, median")
+    ax0.legend(loc="best")
+    ax0.grid()
+
+    ax1.loglog(double_time, double_error, "-o", label="Double")
+    ax1.loglog(mixed_time,  mixed_error,  "-o", label="Mixed")
+    for i in range(len(n)):
+        # labelling the points with grid size and refinement steps
+        ax1.annotate(f"n = {int(n[i])}", (double_time[i], double_error[i]), fontsize=8)
+        ax1.annotate(f"{int(refinements[i])}", (mixed_time[i], mixed_error[i]), fontsize=8)
+    ax1.set_xlabel("Seconds")
+    ax1.set_ylabel("max relative error")
+    ax1.set_title("Error against time")
+    ax1.legend(loc="best")
+    ax1.grid()
+
+    plt.tight_layout(pad=2)
+    plt.show()
+
 def visualize_error():
     """
     Function for plotting and comparing error values for the different
@@ -105,8 +198,7 @@ def visualize_data():
         
         for value in grid_values:
             # iterating over different number of grid points
-            filename = name + value + ".txt"    # fname for specific method and grid points
-            data     = np.loadtxt(filename, skiprows=1)
+            data     = load_data(name + value)  # data for specific method and grid points
             computed = data[:, 1]
 
             if value == "1000":
@@ -128,6 +220,30 @@ def visualize_data():
 
         plt.show()
 
+def load_data(basename):
+    """
+    Loads the exact values, computed values and relative errors written by
+    the C++ program in write mode. Binary .npy-files are memory-mapped, so no
+    data is copied until it is used, and text files are used if there is no
+    .npy-file.
+
+    Parameters
+    ----------
+    basename : str
+        Filename without extension, e.g. "thomas_algorithm_n_10".
+
+    Returns
+    -------
+    data : numpy.ndarray
+        Array of shape (n+2, 3) with the columns exact, computed and relative
+        error.
+    """
+
+    if os.path.isfile(basename + ".npy"):
+        return np.load(basename + ".npy", mmap_mode="r")
+
+    return np.loadtxt(basename + ".txt", skiprows=1)
+
 def plot_data(ax, computed, exact=False):
     """
     A simple function for automation of plotting of computed and exact values.
@@ -157,4 +273,13 @@ if __name__ == "__main__":
     visualize_data()
     visualize_error()
     compare_times()
+
+    # the data of these are only written when the benchmarks are requested
+    # by name or with "all" in the C++ program
+    if os.path.isfile("compare_times_parallel.txt"):
+        compare_times_parallel()
+    if os.path.isfile("compare_times_batched.csv"):
+        compare_times_batched()
+    if os.path.isfile("compare_mixed_precision.txt"):
+        compare_mixed_precision()
     pass
\ No newline at end of file
@@ -5,36 +5,88 @@
 #include <string>
 #include <armadillo>
 #include <chrono>
+#include <algorithm>
+#include <vector>
+#include "tridiagonal_solver.h"
+#include "poisson_problem.h"
+#include "../../common/benchmark.h"
+#include "npy_file.h"
+#include "sweep_driver.h"
+#include "bvp_solver.h"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+extern "C" void dgtsv_(int* n, int* nrhs, double* dl, double* d, double* du,
+    double* b, int* ldb, int* info);
+extern "C" void dgbsv_(int* n, int* kl, int* ku, int* nrhs, double* ab,
+    int* ldab, int* ipiv, double* b, int* ldb, int* info);
+
+bool write_binary = false;  // toggling .npy output instead of .txt for write
 
 void write_to_file(std::string filename, int n, double*v);
+void write_to_file_binary(std::string filename, int n, double* computed_val);
 void write_to_file_error(std::string filename, int n, double*v);
 double relative_error(double v, double u);
 void LU_arma(int n);
 
-double rhs_func(double x) {
+class ErrorWriter
+{
     /*
-    Function for calculating the right-hand-side of the equation, i.e.,
-    f(x) = 100e^(-10x).
-
-    Parameters
-    ----------
-    x : double
-        Function variable.
+    Writer for the max relative error files, which keeps the file open for a
+    whole sweep over grid sizes and collects the lines in a large buffer
+    instead of reopening the file for every grid size. Values are appended to
+    an already existing file with 'filename', in the same format as
+    write_to_file_error.
     */
-    return 100*exp(-10*x);
-}
+private:
+    std::vector<char> buffer;
+    std::ofstream error_file;
 
-double exact_solution(double x) {
-    /*
-    Function for calculating the exact solution to our numerical problem. This will
-    be used for comparing the numerical precision for our computed solution.
+public:
+    ErrorWriter(std::string filename, int buffer_size = 1 << 20)
+    : buffer(buffer_size)
+    {   /*
+        Parameters
+        ----------
+        filename : std::string
+            Filename of output textfile.
+
+        buffer_size : int
+            Size of the write buffer in bytes. Defaults to 1 MB.
+        */
+        // the buffer must be set before the file is opened to take effect
+        error_file.rdbuf()->pubsetbuf(buffer.data(), buffer_size);
+        error_file.open(filename, std::ios_base::app);
+    }
 
-    Parameters
-    ----------
-    x : double
-        Function variable.
+    void write(int n, double max_rel_error)
+    {   /*
+        Parameters
+        ----------
+        n : int
+            Dimension of matrix. Number of discrete points.
+
+        max_rel_error : double
+            Maximum relative error for this grid size.
+        */
+        error_file << std::setw(10) << n;
+        error_file << std::setw(25) << std::setprecision(16) << max_rel_error << "\n";
+    }
+
+    ~ErrorWriter()
+    {
+        error_file.close();
+    }
+};
+
+std::string data_extension() {
+    /*
+    File extension of the data files written by the algorithms in write mode,
+    .npy if write_binary is set and .txt otherwise.
     */
-    return 1 - (1 - exp(-10))*x - exp(-10*x);
+    return write_binary ? ".npy" : ".txt";
 }
 
 double thomas_algorithm(int n, bool write, bool write_error) {
@@ -59,19 +111,14 @@ double thomas_algorithm(int n, bool write, bool write_error) {
         Boolean value for toggling write error to file on/off.
     */
 
-    double stepsize = 1.0/(n+1);
-
     double* lower_diag = new double[n-1]; 
     double* diag       = new double[n];   
     double* upper_diag = new double[n-1]; 
     double* rhs_val    = new double[n];   
     double* computed   = new double[n];   
+    double* work       = new double[n];   
 
-    for (int i=0; i<n; i++)
-    {   // calculating the r.h.s. values
-        double x = stepsize*(i+1);
-        rhs_val[i] = rhs_func(x)*(stepsize*stepsize);
-    }
+    fill_rhs(n, rhs_val);   // calculating the r.h.s. values
 
     for (int i=0; i<n-1; i++)
     {   // inserting values in the diagonals
@@ -84,17 +131,7 @@ double thomas_algorithm(int n, bool write, bool write_error) {
     // start of timing
     std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
 
-    for (int i=0; i<n-1; i++)
-    {   // elimination of bottom diagonal by forward substitution
-        diag[i+1] = diag[i+1] - lower_diag[i]/diag[i]*upper_diag[i];
-        rhs_val[i+1] = rhs_val[i+1] - lower_diag[i]/diag[i]*rhs_val[i];
-    }
-
-    computed[n-1] = rhs_val[n-1]/diag[n-1];
-    for (int i=n-1; i>=1; i--)
-    {   // elimination of top diagonal by backwards substitution
-        computed[i-1] = (rhs_val[i-1] - upper_diag[i-1]*computed[i])/diag[i-1];
-    }
+    solve_tridiagonal_dispatch(n, lower_diag, diag, upper_diag, rhs_val, computed, work);
 
     // end of timing
     std::chrono::steady_clock::time_point t2 = std::chrono::steady_clock::now();
@@ -103,7 +140,7 @@ double thomas_algorithm(int n, bool write, bool write_error) {
 
     if (write) 
     {
-        std::string filename = "thomas_algorithm_n_" + std::to_string(n) + ".txt";
+        std::string filename = "thomas_algorithm_n_" + std::to_string(n) + data_extension();
         write_to_file(filename, n, computed);
     }
 
@@ -117,6 +154,7 @@ double thomas_algorithm(int n, bool write, bool write_error) {
     delete[] upper_diag;
     delete[] rhs_val;
     delete[] computed;
+    delete[] work;
 
     return total_time.count();
 }
@@ -143,62 +181,182 @@ double thomas_algorithm_special(int n, bool write, bool write_error) {
         Boolean value for toggling write error to file on/off.
     */
 
-    double stepsize = 1.0/(n+1);
-
-    double* diag     = new double[n];   
     double* rhs_val  = new double[n];   
     double* computed = new double[n];   
 
-   for (int i=0; i<n; i++)
-    {   // calculating the r.h.s.
-        double x = stepsize*(i+1);
-        rhs_val[i] = rhs_func(x)*(stepsize*stepsize);
+    fill_rhs(n, rhs_val);   // calculating the r.h.s.
+
+    // the reciprocal pivots are kept between calls and only extended when a
+    // larger grid than before is requested, outside of the timed region. One
+    // copy per thread, so that the sweep driver may call this concurrently
+    static thread_local PoissonSolver solver;
+    solver.reserve(n);
+
+    // starting timer
+    std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
+
+    solver.solve(n, rhs_val, computed);
+
+    // ending timer
+    std::chrono::steady_clock::time_point t2 = std::chrono::steady_clock::now();
+    std::chrono::duration<double> total_time = std::chrono::duration_cast<std::chrono::duration<double> >(t2 - t1);
+
+
+
+    if (write) 
+    {   
+        std::string filename = "thomas_algorithm_special_n_" + std::to_string(n) + data_extension();
+        write_to_file(filename, n, computed);
     }
 
-    for (int i=0; i<n; i++)
-    {   // inserting values in the diagonal
-        diag[i] = 2.0;
+    if (write_error)
+    {
+        std::string filename = "thomas_algorithm_special_error.txt";
+        write_to_file_error(filename, n, computed);
     }
 
+    delete[] rhs_val;
+    delete[] computed;
+
+    return total_time.count();
+}
+
+double thomas_algorithm_parallel(int n, bool write, bool write_error) {
+    /*
+    Function for solving the same system as thomas_algorithm, but with the
+    partitioned Thomas algorithm which splits the matrix in one block per
+    OpenMP thread. The number of threads is set with OMP_NUM_THREADS or
+    omp_set_num_threads. Without OpenMP the blocks are solved one after the
+    other.
+
+    Parameters
+    ----------
+    n : int
+        Dimension of matrix. Number of discrete points.
+
+    write : bool
+        Boolean for toggling write to file on/off.
+
+    write_error : bool
+        Boolean value for toggling write error to file on/off.
+    */
+
+    int num_blocks = 1;
+    #ifdef _OPENMP
+    num_blocks = omp_get_max_threads();
+    #endif
+
+    double* lower_diag = new double[n-1]; 
+    double* diag       = new double[n];   
+    double* upper_diag = new double[n-1]; 
+    double* rhs_val    = new double[n];   
+    double* computed   = new double[n];   
+    double* work       = new double[tridiagonal_parallel_work_size(n, num_blocks)];
+
+    fill_rhs(n, rhs_val);   // calculating the r.h.s. values
+
     for (int i=0; i<n-1; i++)
-    {   // forward substituting, separate loop to exclude from timing
-        diag[i+1] = 2.0 - 1.0/diag[i];
+    {   // inserting values in the diagonals
+        lower_diag[i] = -1.0;
+        diag[i]       = 2.0;
+        upper_diag[i] = -1.0;
     }
+    diag[n-1] = 2.0;
 
-    // starting timer
+    // start of timing
     std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
 
-    for (int i=0; i<n-1; i++)
-    {   // forward substituting
-        rhs_val[i+1] = rhs_val[i+1] + rhs_val[i]/diag[i];
+    solve_tridiagonal_parallel(n, lower_diag, diag, upper_diag, rhs_val,
+        computed, work, num_blocks);
+
+    // end of timing
+    std::chrono::steady_clock::time_point t2 = std::chrono::steady_clock::now();
+    std::chrono::duration<double> total_time = std::chrono::duration_cast<std::chrono::duration<double> >(t2 - t1);
+
+    if (write) 
+    {
+        std::string filename = "thomas_algorithm_parallel_n_" + std::to_string(n) + data_extension();
+        write_to_file(filename, n, computed);
     }
 
-    computed[n-1] = rhs_val[n-1]/diag[n-1];
+    if (write_error)
+    {
+        std::string filename = "thomas_algorithm_parallel_error.txt";
+        write_to_file_error(filename, n, computed);
+    }
     
-    for (int i=n-1; i>=1; i--)
-    {   // backward substituting
-        computed[i-1] = (rhs_val[i-1] + computed[i])/diag[i-1];
+    delete[] lower_diag;
+    delete[] diag;
+    delete[] upper_diag;
+    delete[] rhs_val;
+    delete[] computed;
+    delete[] work;
+
+    return total_time.count();
+}
+
+double thomas_algorithm_mixed(int n, bool write, bool write_error) {
+    /*
+    Function for solving the same system as thomas_algorithm with the mixed
+    precision solver, i.e., elimination sweeps in float followed by iterative
+    refinement with a double precision residual, and saving the values to a
+    .txt-file. The factorization and all refinement steps are timed.
+
+    Parameters
+    ----------
+    n : int
+        Dimension of matrix. Number of discrete points.
+
+    write : bool
+        Boolean for toggling write to file on/off.
+
+    write_error : bool
+        Boolean value for toggling write error to file on/off.
+    */
+
+    double* lower_diag = new double[n-1]; 
+    double* diag       = new double[n];   
+    double* upper_diag = new double[n-1]; 
+    double* rhs_val    = new double[n];   
+    double* computed   = new double[n];   
+
+    fill_rhs(n, rhs_val);   // calculating the r.h.s. values
+
+    for (int i=0; i<n-1; i++)
+    {   // inserting values in the diagonals
+        lower_diag[i] = -1.0;
+        diag[i]       = 2.0;
+        upper_diag[i] = -1.0;
     }
+    diag[n-1] = 2.0;
 
-    // ending timer
-    std::chrono::steady_clock::time_point t2 = std::chrono::steady_clock::now();
-    std::chrono::duration<double> total_time = std::chrono::duration_cast<std::chrono::duration<double> >(t2 - t1);
+    MixedPrecisionSolver solver(n);
+
+    // start of timing
+    std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
 
+    solver.factorize(lower_diag, diag, upper_diag);
+    solver.solve(lower_diag, diag, upper_diag, rhs_val, computed);
 
+    // end of timing
+    std::chrono::steady_clock::time_point t2 = std::chrono::steady_clock::now();
+    std::chrono::duration<double> total_time = std::chrono::duration_cast<std::chrono::duration<double> >(t2 - t1);
 
     if (write) 
-    {   
-        std::string filename = "thomas_algorithm_special_n_" + std::to_string(n) + ".txt";
+    {
+        std::string filename = "thomas_algorithm_mixed_n_" + std::to_string(n) + data_extension();
         write_to_file(filename, n, computed);
     }
 
     if (write_error)
     {
-        std::string filename = "thomas_algorithm_special_error.txt";
+        std::string filename = "thomas_algorithm_mixed_error.txt";
         write_to_file_error(filename, n, computed);
     }
-
+    
+    delete[] lower_diag;
     delete[] diag;
+    delete[] upper_diag;
     delete[] rhs_val;
     delete[] computed;
 
@@ -210,6 +368,7 @@ void write_to_file(std::string filename, int n, double* computed_val) {
     Function for writing the values to a .txt-file. Writing the exact and
     computed solution as well as the error for the computed relative to the
     exact solution. If a file with 'filename' already exixts, it is overwritten.
+    Filenames ending with .npy are written with write_to_file_binary instead.
 
     Parameters
     ----------
@@ -223,15 +382,19 @@ void write_to_file(std::string filename, int n, double* computed_val) {
         Pointer to array of computed values to be written to file.
     */
     
+    if ((filename.size() > 4) && (filename.substr(filename.size() - 4) == ".npy"))
+    {
+        write_to_file_binary(filename, n, computed_val);
+        return;
+    }
+
     double* exact_val = new double[n];
     double* eps       = new double[n];
-    double stepsize   = 1.0/(n+1);
-    double x;
+
+    fill_exact(n, exact_val);
 
     for (int i=0; i<n; i++)
-    {   // calculating exact solution and relative error
-        x = stepsize*(i+1);
-        exact_val[i] = exact_solution(x);
+    {   // calculating relative error
         eps[i] = relative_error(computed_val[i], exact_val[i]);
        
     }
@@ -260,6 +423,53 @@ void write_to_file(std::string filename, int n, double* computed_val) {
     results_file.close();
 }
 
+void write_to_file_binary(std::string filename, int n, double* computed_val) {
+    /*
+    Function for writing the same values as write_to_file to a memory-mapped
+    .npy-file, as an (n+2) x 3 array of doubles with the columns exact
+    solution, computed solution and relative error, including the zero
+    boundary values as the first and last rows. The values are computed
+    directly into the mapped file, so no extra arrays are allocated. If a file
+    with 'filename' already exists, it is overwritten.
+
+    The file is loaded zero-copy in Python with np.load(filename, mmap_mode="r").
+
+    Parameters
+    ----------
+    filename : std::string
+        Filename of output .npy-file.
+
+    n : int
+        Dimension of matrix. Number of discrete points.
+
+    computed_val : double*
+        Pointer to array of computed values to be written to file.
+    */
+
+    NpyFile results_file(filename, n+2, 3);
+    double* data = results_file.data();
+    ExactSolution exact(n);
+
+    if (!results_file.is_open())
+    {
+        return;
+    }
+
+    for (int j=0; j<3; j++)
+    {   // known boundary values
+        data[j]         = 0;
+        data[3*(n+1)+j] = 0;
+    }
+
+    for (int i=0; i<n; i++)
+    {   // calculating exact solution and relative error into the file
+        double exact_val = exact(i);
+        data[3*(i+1)]     = exact_val;
+        data[3*(i+1) + 1] = computed_val[i];
+        data[3*(i+1) + 2] = relative_error(computed_val[i], exact_val);
+    }
+}
+
 void write_to_file(std::string filename, int n, arma::vec computed_val) {
     /*
     Function for writing the values to a .txt-file.
@@ -306,12 +516,11 @@ void write_to_file_error(std::string filename, int n, double* computed_val) {
     */
     double exact_val;
     double max_rel_error = 0;
-    double stepsize = 1.0/(n+1);
+    ExactSolution exact(n);
 
     for (int i=0; i<n; i++)
     {
-        double x = stepsize*(i+1);
-        exact_val = exact_solution(x);
+        exact_val = exact(i);
         double rel_error = relative_error(computed_val[i], exact_val);
         
         if (max_rel_error < rel_error)
@@ -389,7 +598,6 @@ double LU_arma(int n, bool write, bool write_error) {
         Boolean value for toggling write error to file on/off.
     */
 
-    double stepsize = 1.0/(n+1);
     arma::mat A(n, n);
 
     A.diag(0)  += 2.0;
@@ -406,11 +614,7 @@ double LU_arma(int n, bool write, bool write_error) {
     L.zeros();
     U.zeros();
 
-   for (int i=0; i<n; i++)
-    {   // calculating r.h.s. values
-        double x = stepsize*(i+1);
-        rhs_val(i) = rhs_func(x)*(stepsize*stepsize);
-    }
+    fill_rhs(n, rhs_val.memptr());  // calculating r.h.s. values
 
     // starting timer
     std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
@@ -426,7 +630,7 @@ double LU_arma(int n, bool write, bool write_error) {
 
     if (write)
     {
-        std::string filename = "LU_n_" + std::to_string(n) + ".txt";
+        std::string filename = "LU_n_" + std::to_string(n) + data_extension();
         write_to_file(filename, n, computed);
     }
 
@@ -441,136 +645,959 @@ double LU_arma(int n, bool write, bool write_error) {
 
 }
 
+double LU_lapack(int n, bool write, bool write_error) {
+    /*
+    Function for solving the tridiagonal system with the LAPACK routine dgtsv,
+    which does Gaussian elimination with partial pivoting on the three
+    diagonals only. Uses O(n) memory, so unlike LU_arma it runs for all grid
+    sizes. Used as a library reference for the Thomas algorithm functions.
+
+    Parameters
+    ----------
+    n : int
+        Dimension of matrix. Number of discrete points.
+    
+    write : bool
+        Boolean value for toggling write to file on/off.
+
+    write_error : bool
+        Boolean value for toggling write error to file on/off.
+    */
+
+    double* lower_diag = new double[n-1]; 
+    double* diag       = new double[n];   
+    double* upper_diag = new double[n-1]; 
+    double* computed   = new double[n];   // r.h.s. on input, solution on output
+
+    fill_rhs(n, computed);  // calculating r.h.s. values
+
+    for (int i=0; i<n-1; i++)
+    {   // inserting values in the diagonals
+        lower_diag[i] = -1.0;
+        diag[i]       = 2.0;
+        upper_diag[i] = -1.0;
+    }
+    diag[n-1] = 2.0;
+
+    int nrhs = 1;
+    int info;
+
+    // starting timer
+    std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
+
+    dgtsv_(&n, &nrhs, lower_diag, diag, upper_diag, computed, &n, &info);
+
+    // ending timer
+    std::chrono::steady_clock::time_point t2 = std::chrono::steady_clock::now();
+    std::chrono::duration<double> total_time = std::chrono::duration_cast<std::chrono::duration<double> >(t2 - t1);
+
+    if (info != 0)
+    {
+        std::cout << "dgtsv failed with info = " << info << std::endl;
+    }
+
+    if (write)
+    {
+        std::string filename = "LU_lapack_n_" + std::to_string(n) + data_extension();
+        write_to_file(filename, n, computed);
+    }
+
+    if (write_error)
+    {
+        std::string filename = "LU_lapack_error.txt";
+        write_to_file_error(filename, n, computed);
+    }
+
+    delete[] lower_diag;
+    delete[] diag;
+    delete[] upper_diag;
+    delete[] computed;
+
+    return total_time.count();
+}
+
+double LU_banded(int n, bool write, bool write_error) {
+    /*
+    Function for solving the tridiagonal system with the general band solver
+    dgbsv from LAPACK, with one sub- and one super-diagonal. The matrix is
+    stored in LAPACK band storage of (2*kl + ku + 1) x n values, i.e., O(n)
+    memory.
+
+    Parameters
+    ----------
+    n : int
+        Dimension of matrix. Number of discrete points.
+    
+    write : bool
+        Boolean value for toggling write to file on/off.
+
+    write_error : bool
+        Boolean value for toggling write error to file on/off.
+    */
+
+
+    int kl   = 1;               // number of sub-diagonals
+    int ku   = 1;               // number of super-diagonals
+    int ldab = 2*kl + ku + 1;   // leading dimension of the band storage
+    int nrhs = 1;
+    int info;
+
+    double* band     = new double[(long)ldab*n]();
+    int*    pivots   = new int[n];
+    double* computed = new double[n];   // r.h.s. on input, solution on output
+
+    fill_rhs(n, computed);  // calculating r.h.s. values
+
+    for (int j=0; j<n; j++)
+    {   // element (i, j) is stored in band[kl + ku + i - j + j*ldab]
+        band[kl + ku + j*ldab] = 2.0;
+        
+        if (j > 0)
+        {
+            band[kl + ku - 1 + j*ldab] = -1.0;
+        }
+        
+        if (j < n-1)
+        {
+            band[kl + ku + 1 + j*ldab] = -1.0;
+        }
+    }
+
+    // starting timer
+    std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
+
+    dgbsv_(&n, &kl, &ku, &nrhs, band, &ldab, pivots, computed, &n, &info);
+
+    // ending timer
+    std::chrono::steady_clock::time_point t2 = std::chrono::steady_clock::now();
+    std::chrono::duration<double> total_time = std::chrono::duration_cast<std::chrono::duration<double> >(t2 - t1);
+
+    if (info != 0)
+    {
+        std::cout << "dgbsv failed with info = " << info << std::endl;
+    }
+
+    if (write)
+    {
+        std::string filename = "LU_banded_n_" + std::to_string(n) + data_extension();
+        write_to_file(filename, n, computed);
+    }
+
+    if (write_error)
+    {
+        std::string filename = "LU_banded_error.txt";
+        write_to_file_error(filename, n, computed);
+    }
+
+    delete[] band;
+    delete[] pivots;
+    delete[] computed;
+
+    return total_time.count();
+}
+
+double LU_sparse(int n, bool write, bool write_error) {
+    /*
+    Function for solving the tridiagonal system with armadillo's sparse matrix
+    class and spsolve, which uses SuperLU. Armadillo must be built with
+    SuperLU support (ARMA_USE_SUPERLU), otherwise spsolve throws, so the
+    benchmarks only call this function when ARMA_USE_SUPERLU is defined. The
+    matrix is built with the batch insertion constructor from a list of
+    locations and values, so the setup is O(n) as well.
+
+    Parameters
+    ----------
+    n : int
+        Dimension of matrix. Number of discrete points.
+    
+    write : bool
+        Boolean value for toggling write to file on/off.
+
+    write_error : bool
+        Boolean value for toggling write error to file on/off.
+    */
+
+    int num_elements = 3*n - 2;
+
+    arma::umat locations(2, num_elements);
+    arma::vec values(num_elements);
+    arma::vec rhs_val(n);
+    arma::vec computed;
+
+    int k = 0;
+    for (int i=0; i<n; i++)
+    {   // listing the non-zero elements of the matrix
+        locations(0, k) = i;
+        locations(1, k) = i;
+        values(k) = 2.0;
+        k++;
+
+        if (i < n-1)
+        {
+            locations(0, k) = i;
+            locations(1, k) = i+1;
+            values(k) = -1.0;
+            k++;
+            
+            locations(0, k) = i+1;
+            locations(1, k) = i;
+            values(k) = -1.0;
+            k++;
+        }
+    }
+
+    arma::sp_mat A(locations, values, n, n);
+
+    fill_rhs(n, rhs_val.memptr());  // calculating r.h.s. values
+
+    // starting timer
+    std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
+
+    arma::spsolve(computed, A, rhs_val);
+
+    // ending timer
+    std::chrono::steady_clock::time_point t2 = std::chrono::steady_clock::now();
+    std::chrono::duration<double> total_time = std::chrono::duration_cast<std::chrono::duration<double> >(t2 - t1);
+
+    if (write)
+    {
+        std::string filename = "LU_sparse_n_" + std::to_string(n) + data_extension();
+        write_to_file(filename, n, computed);
+    }
+
+    if (write_error)
+    {
+        std::string filename = "LU_sparse_error.txt";
+        write_to_file_error(filename, n, computed);
+    }
+
+    return total_time.count();
+}
+
 void compare_times() {
     /*
-    Function for comparing computation times of thomas, thomas special, and LU.
-    Each grid size is calculated 'runs' amount of times, and all timings are
-    written to a text file compare_times.txt. If file with 'filename' already
-    exists, it is overwritten.
+    Function for comparing computation times of thomas, thomas special, thomas
+    parallel (with all available threads), the LAPACK tridiagonal, banded and
+    sparse solvers, and the dense LU.
+
+    Every algorithm and grid size is timed with the benchmark harness in
+    common/benchmark.h, which warms up and repeats each measurement until the
+    median is known to within 1 %. The serial solvers are pinned to the core
+    the function starts on, while the parallel solver and the dense LU, which
+    may use a threaded BLAS, are not pinned. The median, minimum, MAD,
+    confidence interval and throughput are written to compare_times.csv and
+    compare_times.json. If the files already exist, they are overwritten.
     */
 
-    int grid_values = 12;    // number of different grid values
-    int runs = 10;          // number of runs for each grid size
-    int N[grid_values];
+    const int grid_values = 12;     // number of different grid values
+    int N[grid_values] = {10, 100, 500, 1000, 5000, 10000, 50000, 100000,
+                          500000, 1000000, 5000000, 10000000};
 
-    N[0]  = 10;
-    N[1]  = 100;
-    N[2]  = 500;
-    N[3]  = 1000;
-    N[4]  = 5000;
-    N[5]  = 10000;
-    N[6]  = 50000;
-    N[7]  = 100000;
-    N[8]  = 500000;
-    N[9]  = 1000000;
-    N[10] = 5000000;
-    N[11] = 10000000;
+    Benchmark bench;
+    bench.set_repetitions(2, 10, 500);  // warm-up, minimum and maximum runs
+    bench.set_stop_criteria(0.01, 10);  // 1 % confidence interval, 10 s limit
+    int core = Benchmark::current_cpu();    // core of the serial solvers
+
+    for (int i=0; i<grid_values; i++)
+    {   // looping over each grid size
+        int n = N[i];
+        std::cout << "calculating grid size " + std::to_string(n)
+            + " of " + std::to_string(N[grid_values-1]) << std::endl;
 
+        // flops and bytes per call are counted from the loops of each solver
+        bench.set_core(core);
+        bench.run("thomas algorithm", n, 8.0*n, 72.0*n,
+            [n]() { return thomas_algorithm(n, false, false); });
+        bench.run("thomas algorithm special", n, 4.0*n, 48.0*n,
+            [n]() { return thomas_algorithm_special(n, false, false); });
+        bench.set_core(-1);     // the threads of the parallel solver are not pinned
+        bench.run("thomas algorithm parallel", n, 20.0*n, 160.0*n,
+            [n]() { return thomas_algorithm_parallel(n, false, false); });
+        bench.set_core(core);
+        bench.run("thomas algorithm mixed", n, 0, 0,
+            [n]() { return thomas_algorithm_mixed(n, false, false); });
+        bench.run("LU lapack", n, 8.0*n, 72.0*n,
+            [n]() { return LU_lapack(n, false, false); });
+        bench.run("LU banded", n, 8.0*n, 88.0*n,
+            [n]() { return LU_banded(n, false, false); });
+        #ifdef ARMA_USE_SUPERLU
+        bench.run("LU sparse", n, 0, 0,
+            [n]() { return LU_sparse(n, false, false); });
+        #endif
+
+        if (n <= 5000)
+        {   // limits the gid size for the dense LU since the calculations
+            // are impossible with normal hardware at values approaching 100000
+            bench.set_core(-1);
+            bench.run("LU", n, 2.0/3.0*n*n*n, 24.0*n*n,
+                [n]() { return LU_arma(n, false, false); });
+        }
+    }
+
+    bench.write_csv("compare_times.csv");
+    bench.write_json("compare_times.json");
+}
+
+void compare_times_parallel() {
+    /*
+    Function for measuring the strong scaling of the partitioned Thomas
+    algorithm. Each grid size is solved with 1, 2, 4, ... threads up to the
+    number of available threads, 'runs' amount of times each, and the timings
+    are written to compare_times_parallel.txt together with the serial Thomas
+    algorithm for reference. If the file already exists, it is overwritten.
+    */
 
+    const int grid_values = 4;      // number of different grid values
+    int runs = 10;                  // number of runs for each grid size
+    int N[grid_values] = {100000, 1000000, 10000000, 50000000};
+    int max_threads = 1;
+    #ifdef _OPENMP
+    max_threads = omp_get_max_threads();
+    #endif
 
-    // creating file and writing headers
-    std::string filename = "compare_times.txt";
     std::ofstream compare_times_file;
-    compare_times_file.open(filename);
-    compare_times_file  << std::setw(40) << "thomas algorithm"
-                        << std::setw(40) << "thomas algorithm special"
-                        << std::setw(40) << "LU\n"
-                        << std::setw(40) << runs
-                        << std::setw(40) << runs
-                        << std::setw(40) << runs << "\n"
-                        << std::setw(40) << grid_values
-                        << std::setw(40) << grid_values
-                        << std::setw(40) << grid_values << "\n";
+    compare_times_file.open("compare_times_parallel.txt");
+    compare_times_file  << std::setw(10) << "n"
+                        << std::setw(10) << "threads"
+                        << std::setw(40) << "thomas algorithm"
+                        << std::setw(40) << "thomas algorithm parallel\n";
 
     for (int i=0; i<grid_values; i++)
     {   // looping over each grid size
-        // writing grid size info to file
-        std::cout << "calculating grid size " + std::to_string(N[i])
-            + " of " + std::to_string(N[grid_values-1]) << std::endl;
-        compare_times_file  << std::setw(40) << std::to_string(N[i])
-                            << std::setw(40) << std::to_string(N[i])
-                            << std::setw(40) << std::to_string(N[i])
-                            << "\n";
         
-        for (int _=0; _<runs; _++)
-        {   // looping over each grid size 'runs' amount of times
-            // writing timing data to file
-            compare_times_file  << std::setw(40) << std::setprecision(32) 
-                                << thomas_algorithm(N[i], false, false)
-                                << std::setw(40) << std::setprecision(32)
-                                << thomas_algorithm_special(N[i], false, false);
-            
-            if (N[i] <= 5000)
-            {   // limits the gid size for LU since the calculations are
-                // impossible with normal hardware at values approaching 100000
-            compare_times_file  << std::setw(40) << std::setprecision(32)
-                                << LU_arma(N[i], false, false) << std::endl;
-            }
+        for (int threads=1; threads<=max_threads; threads*=2)
+        {   // doubling the number of threads
+            std::cout << "calculating grid size " + std::to_string(N[i])
+                + " with " + std::to_string(threads) + " threads" << std::endl;
             
-            else
-            {   // writes -1 if LU is incapable of providing results
-            compare_times_file  << std::setw(40) << std::setprecision(32)
-                                << -1 << std::endl;  
+            #ifdef _OPENMP
+            omp_set_num_threads(threads);
+            #endif
+
+            for (int _=0; _<runs; _++)
+            {
+                compare_times_file  << std::setw(10) << N[i]
+                                    << std::setw(10) << threads
+                                    << std::setw(40) << std::setprecision(32)
+                                    << thomas_algorithm(N[i], false, false)
+                                    << std::setw(40) << std::setprecision(32)
+                                    << thomas_algorithm_parallel(N[i], false, false)
+                                    << std::endl;
             }
-                                
         }
     }
 
+    #ifdef _OPENMP
+    omp_set_num_threads(max_threads);
+    #endif
+    
     compare_times_file.close();
 }
 
-void calculate_error() {
+void compare_mixed_precision() {
+    /*
+    Function for comparing time and accuracy of the double precision Thomas
+    algorithm and the mixed precision solver. The timings are the medians from
+    the benchmark harness. Each line of compare_mixed_precision.txt contains
+    the grid size, the time and max relative error of thomas_algorithm, the
+    time and max relative error of the mixed precision solver, and the number
+    of refinement steps it needed. If the file already exists, it is
+    overwritten.
+    */
+
+    const int grid_values = 12;     // number of different grid values
+    int N[grid_values] = {10, 100, 500, 1000, 5000, 10000, 50000, 100000,
+                          500000, 1000000, 5000000, 10000000};
+
+    Benchmark bench;
+    bench.set_repetitions(2, 10, 500);  // warm-up, minimum and maximum runs
+    bench.set_stop_criteria(0.01, 10);  // 1 % confidence interval, 10 s limit
+
+    std::ofstream mixed_file;
+    mixed_file.open("compare_mixed_precision.txt");
+    mixed_file << std::setw(10) << "n" << std::setw(25) << "double time"
+               << std::setw(25) << "double error" << std::setw(25) << "mixed time"
+               << std::setw(25) << "mixed error" << std::setw(15) << "refinements\n";
+
+    for (int i=0; i<grid_values; i++)
+    {   // looping over each grid size
+        int n = N[i];
+        std::cout << "calculating grid size " + std::to_string(n)
+            + " of " + std::to_string(N[grid_values-1]) << std::endl;
+
+        double double_time = bench.run("thomas algorithm", n, 8.0*n, 72.0*n,
+            [n]() { return thomas_algorithm(n, false, false); }).median;
+        double mixed_time  = bench.run("thomas algorithm mixed", n, 0, 0,
+            [n]() { return thomas_algorithm_mixed(n, false, false); }).median;
+
+        // one more solve of each, for the errors
+        std::vector<double> lower_diag(n, -1.0);
+        std::vector<double> diag(n, 2.0);
+        std::vector<double> upper_diag(n, -1.0);
+        std::vector<double> rhs_val(n);
+        std::vector<double> computed(n);
+        std::vector<double> work(n);
+        fill_rhs(n, rhs_val.data());
+
+        double double_error = solve_tridiagonal_max_rel_error(n, lower_diag.data(),
+            diag.data(), upper_diag.data(), rhs_val.data(), computed.data(),
+            work.data(), ExactSolution(n));
+
+        MixedPrecisionSolver solver(n);
+        solver.factorize(lower_diag.data(), diag.data(), upper_diag.data());
+        solver.solve(lower_diag.data(), diag.data(), upper_diag.data(),
+            rhs_val.data(), computed.data());
+
+        double mixed_error = 0;
+        ExactSolution exact(n);
+        for (int j=0; j<n; j++)
+        {
+            mixed_error = std::max(mixed_error, relative_error(computed[j], exact(j)));
+        }
+
+        mixed_file << std::setw(10) << n << std::setprecision(16)
+                   << std::setw(25) << double_time << std::setw(25) << double_error
+                   << std::setw(25) << mixed_time << std::setw(25) << mixed_error
+                   << std::setw(15) << solver.last_refinements() << "\n";
+    }
+    mixed_file.close();
+}
+
+void compare_times_fixed() {
+    /*
+    Function for comparing the runtime-n Thomas algorithm used by
+    thomas_algorithm before, solve_tridiagonal, with the compile-time
+    instances TridiagSolver<N> which thomas_algorithm now dispatches to, for
+    the grid sizes with an instance. A single solve at these sizes is too
+    short to time on its own, so every timing is of 'repeats' solves on the
+    same buffers, and the time per solve is reported. The results are written
+    to compare_times_fixed.csv and compare_times_fixed.json. If the files
+    already exist, they are overwritten.
+    */
+
+    const int grid_values = 3;      // number of different grid values
+    int N[grid_values] = {10, 100, 500};
+    const int elements = 1000000;   // grid points solved per timing
+
+    Benchmark bench;
+    bench.set_repetitions(2, 10, 500);  // warm-up, minimum and maximum runs
+    bench.set_stop_criteria(0.01, 10);  // 1 % confidence interval, 10 s limit
+
+    for (int i=0; i<grid_values; i++)
+    {   // looping over each grid size
+        int n       = N[i];
+        int repeats = elements/n;
+
+        std::vector<double> lower_diag(n, -1.0);
+        std::vector<double> diag(n, 2.0);
+        std::vector<double> upper_diag(n, -1.0);
+        std::vector<double> rhs_val(n);
+        std::vector<double> computed(n);
+        std::vector<double> work(n);
+        fill_rhs(n, rhs_val.data());
+
+        auto time_solves = [&](bool fixed)
+        {
+            std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
+            for (int r=0; r<repeats; r++)
+            {
+                if (fixed)
+                {
+                    solve_tridiagonal_dispatch(n, lower_diag.data(), diag.data(),
+                        upper_diag.data(), rhs_val.data(), computed.data(), work.data());
+                }
+                else
+                {
+                    solve_tridiagonal(n, lower_diag.data(), diag.data(),
+                        upper_diag.data(), rhs_val.data(), computed.data(), work.data());
+                }
+            }
+            std::chrono::steady_clock::time_point t2 = std::chrono::steady_clock::now();
+            std::chrono::duration<double> total_time = std::chrono::duration_cast<std::chrono::duration<double> >(t2 - t1);
+            return total_time.count()/repeats;
+        };
+
+        bench.run("thomas algorithm", n, 8.0*n, 72.0*n,
+            [&]() { return time_solves(false); });
+        bench.run("thomas algorithm fixed n", n, 8.0*n, 72.0*n,
+            [&]() { return time_solves(true); });
+    }
+
+    bench.write_csv("compare_times_fixed.csv");
+    bench.write_json("compare_times_fixed.json");
+}
+
+void compare_times_batched() {
     /*
-    Function for running the three different algorithms in error write mode for
-    a set of grid point values. The error data are written to three .txt files.
+    Function for comparing the batched Thomas algorithm, which solves K
+    interleaved systems at once, against K sequential calls to the general
+    Thomas algorithm. All systems use the (-1, 2, -1) matrix with differently
+    scaled right-hand sides. Every grid size is solved with K = 1, 4, ...,
+    4096 systems, as long as n*K is below ~2e7 values, i.e., below ~1 GB in
+    total, so that thousands of small systems are measured as well as a few
+    large ones. The layouts are filled outside of the timed region, and every
+    combination is timed with the benchmark harness in common/benchmark.h.
+    The results are written to compare_times_batched.csv and
+    compare_times_batched.json, with the names "sequential K=<K>" and
+    "batched K=<K>". If the files already exist, they are overwritten.
+    */
+
+    const int grid_values  = 7;     // number of different grid values
+    const int batch_values = 7;     // number of different batch sizes
+    long max_elements = 20000000;   // upper limit for n*batch
+    int N[grid_values]        = {10, 100, 1000, 10000, 100000, 1000000, 10000000};
+    int batches[batch_values] = {1, 4, 16, 64, 256, 1024, 4096};
+
+    Benchmark bench;
+    bench.set_repetitions(2, 10, 500);  // warm-up, minimum and maximum runs
+    bench.set_stop_criteria(0.01, 10);  // 1 % confidence interval, 10 s limit
+    bench.set_core(Benchmark::current_cpu());
+
+    for (int i=0; i<grid_values; i++)
+    {   // looping over each grid size
+        int n = N[i];
+        std::vector<double> first_rhs(n);
+        fill_rhs(n, first_rhs.data());  // r.h.s. of the first system
+
+        for (int b=0; b<batch_values; b++)
+        {   // looping over each batch size
+            int batch = batches[b];
+            long size = (long)n*batch;
+
+            if ((batch > 1) && (size > max_elements))
+            {
+                break;
+            }
+
+            std::cout << "calculating grid size " + std::to_string(n)
+                + " with " + std::to_string(batch) + " systems" << std::endl;
+
+            std::vector<double> lower_diag(size, -1.0);
+            std::vector<double> diag(size, 2.0);
+            std::vector<double> upper_diag(size, -1.0);
+            std::vector<double> rhs_val(size);
+            std::vector<double> computed(size);
+            std::vector<double> work(size);
+
+            // 8 flops and 72 bytes per unknown, as thomas_algorithm
+            double flops = 8.0*size;
+            double bytes = 72.0*size;
+            std::string suffix = " K=" + std::to_string(batch);
+
+            for (int k=0; k<batch; k++)
+            {   // one system after the other (array of structures)
+                for (int j=0; j<n; j++)
+                {
+                    rhs_val[(long)k*n + j] = (1.0 + k)*first_rhs[j];
+                }
+            }
+
+            bench.run("sequential" + suffix, n, flops, bytes, [&]()
+            {
+                for (int k=0; k<batch; k++)
+                {
+                    long offset = (long)k*n;
+                    solve_tridiagonal(n, lower_diag.data() + offset,
+                        diag.data() + offset, upper_diag.data() + offset,
+                        rhs_val.data() + offset, computed.data() + offset,
+                        work.data() + offset);
+                }
+            });
+
+            for (int j=0; j<n; j++)
+            {   // the same systems interleaved (structure of arrays)
+                for (int k=0; k<batch; k++)
+                {
+                    rhs_val[(long)j*batch + k] = (1.0 + k)*first_rhs[j];
+                }
+            }
+
+            bench.run("batched" + suffix, n, flops, bytes, [&]()
+            {
+                solve_tridiagonal_batched(n, batch, lower_diag.data(),
+                    diag.data(), upper_diag.data(), rhs_val.data(),
+                    computed.data(), work.data());
+            });
+        }
+    }
+
+    bench.write_csv("compare_times_batched.csv");
+    bench.write_json("compare_times_batched.json");
+}
+
+std::vector<int> error_grid_values() {
+    /*
+    The grid sizes of the error sweeps, 10^(7i/1000) for i = 145, ..., 1000
+    without the duplicates caused by rounding from double to int, in
+    increasing order.
     */
 
     int end = 1000;
     int tmp = 0;
 
+    std::vector<int> N;
     for (int i=145; i<=end; i++)
-    {   // iterating over a set of grid values
+    {   // set of grid values
         int n = (int)std::pow(10, 7.0/end*i);
         
         if (n != tmp)
         {   // excluding equal values caused by rounding from double to int
             tmp = n;
-            std::cout << "calculating n = " + std::to_string(n) << std::endl;
-            
-            thomas_algorithm(n, false, true);
-            thomas_algorithm_special(n, false, true);
-            
-            if (n < 1500)
-            {   // sets a limit for the LU decomp. because of hardware limitations
-                LU_arma(n, false, true);
+            N.push_back(n);
+        }
+    }
+    return N;
+}
+
+void calculate_error() {
+    /*
+    Function for running the different algorithms in error write mode for a set
+    of grid point values. The error data are written to one .txt file per
+    algorithm.
+
+    The general and special Thomas algorithms use the fused kernels, which
+    accumulate the max relative error during the backward substitution. The
+    grid sizes are distributed over all cores with the sweep driver. The
+    diagonals are shared between the workers, and each worker keeps its own
+    r.h.s. and solution buffers, which are only reallocated when the worker
+    gets a larger grid than before. The errors are collected in grid order and
+    written through one buffered writer per file.
+
+    The dense LU is checked afterwards for the grid sizes below 1500, one
+    at a time. The parallel, mixed precision and LAPACK solvers are not
+    fused, and are only checked in calculate_error_extra.
+    */
+
+    std::vector<int> N = error_grid_values();
+    int n_max = N.back();
+
+    // the diagonals are not modified by the solvers, and are shared by all
+    // workers
+    std::vector<double> lower_diag(n_max, -1.0);
+    std::vector<double> diag(n_max, 2.0);
+    std::vector<double> upper_diag(n_max, -1.0);
+
+    PoissonSolver poisson_solver(n_max);
+
+    SweepDriver driver;
+    std::vector<std::vector<double> > rhs_val(driver.threads());
+    std::vector<std::vector<double> > computed(driver.threads());
+    std::vector<std::vector<double> > work(driver.threads());
+
+    struct ErrorRow
+    {
+        double thomas;
+        double thomas_special;
+    };
+
+    std::vector<ErrorRow> errors = driver.run(N.size(), [&](int item, int worker)
+    {
+        int n = N[item];
+        ExactSolution exact(n);
+
+        if ((int)rhs_val[worker].size() < n)
+        {   // growing the buffers of this worker
+            rhs_val[worker].resize(n);
+            computed[worker].resize(n);
+            work[worker].resize(n);
+        }
+
+        double* rhs = rhs_val[worker].data();
+        fill_rhs(n, rhs);   // calculating the r.h.s. values
+
+        ErrorRow row;
+        row.thomas = solve_tridiagonal_max_rel_error(n, lower_diag.data(),
+            diag.data(), upper_diag.data(), rhs, computed[worker].data(),
+            work[worker].data(), exact);
+        row.thomas_special = poisson_solver.solve_max_rel_error(n, rhs,
+            computed[worker].data(), exact);
+        return row;
+    });
+
+    {   // the writers are closed at the end of this scope
+        ErrorWriter thomas_file("thomas_algorithm_error.txt");
+        ErrorWriter thomas_special_file("thomas_algorithm_special_error.txt");
+
+        for (std::size_t i=0; i<N.size(); i++)
+        {
+            thomas_file.write(N[i], errors[i].thomas);
+            thomas_special_file.write(N[i], errors[i].thomas_special);
+        }
+    }
+
+    for (int n : N)
+    {   // sets a limit for the LU decomp. because of hardware limitations
+        if (n >= 1500)
+        {
+            break;
+        }
+
+        std::cout << "calculating n = " + std::to_string(n) << std::endl;
+        LU_arma(n, false, true);
+    }
+}
+
+void calculate_error_extra() {
+    /*
+    Function for running the parallel Thomas algorithm, the mixed precision
+    solver and the LAPACK tridiagonal solver in error write mode for the grid
+    sizes of calculate_error. These solvers have no fused error kernels, so
+    every grid size is solved, compared against the exact solution and
+    appended to the error file separately, one grid size at a time. The error
+    data are written to one .txt file per algorithm.
+    */
+
+    for (int n : error_grid_values())
+    {
+        std::cout << "calculating n = " + std::to_string(n) << std::endl;
+
+        thomas_algorithm_parallel(n, false, true);
+        thomas_algorithm_mixed(n, false, true);
+        LU_lapack(n, false, true);
+    }
+}
+
+void calculate_bvp_convergence() {
+    /*
+    Function for checking that BVPSolver is of second order. Each case is
+    solved with N = 20, 40, ..., 1280 intervals, and the max error and the
+    observed order log2(e(N/2)/e(N)) are written to bvp_convergence.txt.
+    If the file already exists, it is overwritten.
+
+    The cases are
+        dirichlet           p = 1, q = 0, f = rhs_func and u = 0 at both ends
+                            on the uniform grid of thomas_algorithm, the max
+                            relative error against exact_solution.
+        robin uniform       the manufactured solution u = sin(pi x) + x^2
+                            with p = 1 + x and q = 2, a Robin condition
+                            u - u'/2 = u(0) - u'(0)/2 at x = 0 and the
+                            Neumann condition u' = u'(1) at x = 1, the max
+                            absolute error.
+        robin stretched     the same on x_i = t^2(3 - 2t), t = i/N, which is
+                            finer near both ends.
+    */
+
+    const double pi = std::acos(-1.0);
+    auto u   = [pi](double x) { return std::sin(pi*x) + x*x; };
+    auto du  = [pi](double x) { return pi*std::cos(pi*x) + 2*x; };
+    auto d2u = [pi](double x) { return -pi*pi*std::sin(pi*x) + 2; };
+    auto p   = [](double x) { return 1 + x; };
+    auto q   = [](double) { return 2.0; };
+    auto f   = [&](double x) { return -(du(x) + p(x)*d2u(x)) + 2*u(x); };
+
+    BoundaryCondition dirichlet{1, 0, 0};
+    BoundaryCondition robin{1, -0.5, u(0) - 0.5*du(0)};
+    BoundaryCondition neumann{0, 1, du(1)};
+
+    std::ofstream bvp_file;
+    bvp_file.open("bvp_convergence.txt");
+    bvp_file << std::setw(20) << "case" << std::setw(10) << "N"
+             << std::setw(25) << "error" << std::setw(15) << "order\n";
+
+    BVPSolver solver(1281);
+    std::vector<double> x;
+    std::vector<double> computed;
+
+    for (std::string name : {"dirichlet", "robin uniform", "robin stretched"})
+    {
+        double previous = 0;
+
+        for (int N=20; N<=1280; N*=2)
+        {   // doubling the number of intervals
+            x.resize(N+1);
+            computed.resize(N+1);
+            double error = 0;
+
+            for (int i=0; i<=N; i++)
+            {
+                double t = (double)i/N;
+                x[i] = (name == "robin stretched") ? t*t*(3 - 2*t) : t;
+            }
+
+            if (name == "dirichlet")
+            {
+                solver.solve(N+1, x.data(), [](double) { return 1.0; },
+                    [](double) { return 0.0; }, rhs_func, dirichlet, dirichlet,
+                    computed.data());
+
+                for (int i=1; i<N; i++)
+                {
+                    error = std::max(error, relative_error(computed[i], exact_solution(x[i])));
+                }
             }
+            else
+            {
+                solver.solve(N+1, x.data(), p, q, f, robin, neumann, computed.data());
+
+                for (int i=0; i<=N; i++)
+                {
+                    error = std::max(error, std::fabs(computed[i] - u(x[i])));
+                }
+            }
+
+            bvp_file << std::setw(20) << name << std::setw(10) << N
+                     << std::setw(25) << std::setprecision(10) << error;
+            if (previous > 0) bvp_file << std::setw(15) << std::log2(previous/error);
+            bvp_file << "\n";
+            previous = error;
         }
     }
+    bvp_file.close();
 }
 
 void calculate_data() {
     /*
     Function for running the three different algorithms for a set of grid point
-    values. Data is written to three .txt files.
+    values. Data is written to three .txt files. Every (algorithm, grid size)
+    pair writes its own file, and the pairs are run concurrently with the sweep
+    driver.
     */
 
-    int n;
+    double (*algorithms[3])(int, bool, bool) = {thomas_algorithm,
+        thomas_algorithm_special, LU_arma};
 
-    for (int i=1; i<4; i++)
-    {   // looping over a set of grid values
-        n = (int)std::pow(10, i);
-        
-        thomas_algorithm(n, true, false);
-        thomas_algorithm_special(n, true, false);
-        LU_arma(n, true, false);      
+    SweepDriver driver;
+    driver.run(9, [&algorithms](int item, int)
+    {   // looping over a set of grid values for each algorithm
+        int n = (int)std::pow(10, item/3 + 1);
+        return algorithms[item%3](n, true, false);
+    });
+}
+
+void compare_times_sweep() {
+    /*
+    Function for timing the algorithms concurrently on all cores. Every
+    (algorithm, n, repetition) combination is one work item of the sweep
+    driver, which runs one item at a time on each pinned core and steals work
+    between cores. The single timings are written in item order to
+    compare_times_sweep.csv, together with the core each one ran on. If the
+    file already exists, it is overwritten.
+
+    The timings of the memory bound solvers at the largest grid sizes include
+    the contention for memory bandwidth between the cores. compare_times()
+    measures each algorithm alone, and should be used when that matters. The
+    parallel Thomas algorithm uses all threads itself, and is not included.
+    Neither is the dense LU: each of its items at n = 5000 needs a 200 MB
+    matrix plus the LU factors, so one per core would need tens of GB on a
+    large node. compare_times() times it alone.
+    */
+
+    const int grid_values = 12;     // number of different grid values
+    const int repetitions = 10;     // number of timings per algorithm and grid size
+    int N[grid_values] = {10, 100, 500, 1000, 5000, 10000, 50000, 100000,
+                          500000, 1000000, 5000000, 10000000};
+
+    struct Algorithm
+    {
+        std::string name;
+        double (*func)(int, bool, bool);
+    };
+
+    std::vector<Algorithm> algorithms = {
+        {"thomas algorithm",         thomas_algorithm},
+        {"thomas algorithm special", thomas_algorithm_special},
+        {"LU lapack",                LU_lapack},
+        {"LU banded",                LU_banded}
+    };
+
+    #ifdef ARMA_USE_SUPERLU
+    algorithms.push_back({"LU sparse", LU_sparse});
+    #endif
+
+    struct SweepItem
+    {
+        int algorithm;
+        int n;
+        int repetition;
+    };
+
+    std::vector<SweepItem> items;
+    for (int a=0; a<(int)algorithms.size(); a++)
+    {
+        for (int i=0; i<grid_values; i++)
+        {
+            for (int r=0; r<repetitions; r++)
+            {
+                items.push_back({a, N[i], r});
+            }
+        }
     }
+
+    struct SweepTiming
+    {
+        double time;
+        int cpu;
+    };
+
+    SweepDriver driver;
+    std::cout << "timing " << items.size() << " items on " << driver.threads()
+              << " threads" << std::endl;
+
+    std::vector<SweepTiming> timings = driver.run(items.size(),
+        [&](int item, int)
+    {
+        const SweepItem& it = items[item];
+        SweepTiming timing;
+        timing.time = algorithms[it.algorithm].func(it.n, false, false);
+        timing.cpu  = Benchmark::current_cpu();
+        return timing;
+    });
+
+    std::ofstream csv_file;
+    csv_file.open("compare_times_sweep.csv");
+    csv_file << "name,size,repetition,time,cpu\n";
+    csv_file << std::setprecision(10);
+
+    for (std::size_t i=0; i<items.size(); i++)
+    {
+        csv_file << algorithms[items[i].algorithm].name << "," << items[i].n
+                 << "," << items[i].repetition << "," << timings[i].time
+                 << "," << timings[i].cpu << "\n";
+    }
+    csv_file.close();
 }
 
 
 
-int main()
-{
+int main(int argc, char* argv[])
+{   /*
+    Runs compare_times, calculate_error and calculate_data. The other
+    benchmarks go up to n = 10^7 and take long, so they are only run when
+    named on the command line, e.g., ./run.out compare_times_parallel, or all
+    of them with ./run.out all.
+    */
+
+    std::vector<std::string> extra = {"compare_times_parallel",
+        "compare_times_batched", "compare_times_fixed",
+        "compare_mixed_precision", "compare_times_sweep",
+        "calculate_error_extra", "calculate_bvp_convergence"};
+    std::vector<std::string> args(argv + 1, argv + argc);
+
+    for (const std::string& arg : args)
+    {
+        if ((arg != "all") && (std::find(extra.begin(), extra.end(), arg) == extra.end()))
+        {
+            std::cout << "unknown benchmark " << arg << ", choose from all";
+            for (const std::string& name : extra) std::cout << " " << name;
+            std::cout << std::endl;
+            return 1;
+        }
+    }
+
+    auto requested = [&args](std::string name)
+    {
+        return (std::find(args.begin(), args.end(), name) != args.end())
+            || (std::find(args.begin(), args.end(), "all") != args.end());
+    };
+
     compare_times();
+    if (requested("compare_times_parallel"))  compare_times_parallel();
+    if (requested("compare_times_batched"))   compare_times_batched();
+    if (requested("compare_times_fixed"))     compare_times_fixed();
+    if (requested("compare_mixed_precision")) compare_mixed_precision();
+    if (requested("compare_times_sweep"))     compare_times_sweep();
+    if (requested("calculate_error_extra"))   calculate_error_extra();
+    if (requested("calculate_bvp_convergence")) calculate_bvp_convergence();
     calculate_error();
     calculate_data();
  
@@ -0,0 +1,208 @@
+#ifndef BVP_SOLVER_H
+#define BVP_SOLVER_H
+
+#include <vector>
+#include "tridiagonal_solver.h"
+
+
+struct BoundaryCondition
+{
+    /*
+    Boundary condition alpha*u + beta*u' = gamma at one end of the interval,
+    where u' is the derivative with respect to x. beta = 0 is a Dirichlet
+    condition, alpha = 0 a Neumann condition, and both non-zero a Robin
+    condition.
+    */
+    double alpha;
+    double beta;
+    double gamma;
+};
+
+
+class BVPSolver
+{
+    /*
+    Solver for the linear boundary-value problem
+
+        -(p(x)u'(x))' + q(x)u(x) = f(x),  x_0 < x < x_N,
+
+    with a BoundaryCondition at each end, on a possibly non-uniform grid
+    x_0 < x_1 < ... < x_N.
+
+    The equation is integrated over the control volume around each grid point,
+    which for point i reaches halfway to its neighbours, with p evaluated at
+    the cell faces (x_i + x_{i+1})/2 and q and f at the grid point. This gives
+    a tridiagonal system with one unknown per grid point, which is the usual
+    second order scheme on uniform grids, and with p = 1, q = 0 and Dirichlet
+    conditions is 1/h times the (-1, 2, -1) system of thomas_algorithm. The
+    interior rows are symmetric, but a Dirichlet row only zeroes its own
+    off-diagonal entry and not the one of its neighbour, so the matrix is not
+    symmetric in general. At a Neumann or Robin end the half control volume at the
+    boundary uses the flux p*u' given by the boundary condition. At a Dirichlet
+    end the row is u = gamma/alpha.
+
+    The system is assembled directly into buffers owned by the solver, and
+    solved with solve_tridiagonal, so a solve costs O(n) and allocates nothing
+    once the buffers are large enough. The matrix is not pivoted, which is
+    fine for p > 0 and q >= 0. With Neumann conditions at both ends, q must be
+    non-zero somewhere, otherwise the solution is only defined up to a
+    constant and the system is singular.
+    */
+private:
+    int n = 0;                          // number of grid points of the last assembly
+    std::vector<double> lower_diag;
+    std::vector<double> diag;
+    std::vector<double> upper_diag;
+    std::vector<double> rhs_val;
+    std::vector<double> work;
+
+public:
+    BVPSolver(int max_points = 0)
+    {   /*
+        Parameters
+        ----------
+        max_points : int
+            Largest number of grid points which will be used. Larger grids are
+            still accepted, but make the buffers grow.
+        */
+        reserve(max_points);
+    }
+
+    void reserve(int max_points)
+    {   /*
+        Grows the buffers to hold a grid of max_points points. Does nothing if
+        they are already large enough.
+
+        Parameters
+        ----------
+        max_points : int
+            Number of grid points.
+        */
+        if ((int)diag.size() >= max_points)
+        {
+            return;
+        }
+
+        lower_diag.resize(max_points);
+        diag.resize(max_points);
+        upper_diag.resize(max_points);
+        rhs_val.resize(max_points);
+        work.resize(max_points);
+    }
+
+    template <class P, class Q, class F>
+    void assemble(int num_points, const double* x, P p, Q q, F f,
+        BoundaryCondition left, BoundaryCondition right)
+    {   /*
+        Assembles the tridiagonal system for a grid and set of coefficients.
+
+        Parameters
+        ----------
+        num_points : int
+            Number of grid points, N + 1 >= 2.
+
+        x : const double*
+            Grid points in increasing order, num_points values.
+
+        p : callable
+            Diffusion coefficient, p(x) > 0, called as p(double).
+
+        q : callable
+            Reaction coefficient, q(x) >= 0, called as q(double).
+
+        f : callable
+            Source term, called as f(double).
+
+        left : BoundaryCondition
+            Boundary condition at x_0.
+
+        right : BoundaryCondition
+            Boundary condition at x_N.
+        */
+        reserve(num_points);
+        n = num_points;
+        int last = n - 1;
+
+        double h_prev = x[1] - x[0];
+        double p_prev = p(0.5*(x[0] + x[1]));   // p at the face between x_0 and x_1
+
+        if (left.beta == 0)
+        {   // Dirichlet
+            diag[0]       = 1;
+            upper_diag[0] = 0;
+            rhs_val[0]    = left.gamma/left.alpha;
+        }
+        else
+        {   // half control volume with the flux -p*u' = -p*(gamma - alpha*u)/beta
+            double p_end  = p(x[0]);
+            diag[0]       = p_prev/h_prev - p_end*left.alpha/left.beta + q(x[0])*h_prev/2;
+            upper_diag[0] = -p_prev/h_prev;
+            rhs_val[0]    = f(x[0])*h_prev/2 - p_end*left.gamma/left.beta;
+        }
+
+        for (int i=1; i<last; i++)
+        {   // interior control volumes of width (h_{i-1} + h_i)/2
+            double h_next = x[i+1] - x[i];
+            double p_next = p(0.5*(x[i] + x[i+1]));
+            double width  = 0.5*(h_prev + h_next);
+
+            lower_diag[i-1] = -p_prev/h_prev;
+            diag[i]         = p_prev/h_prev + p_next/h_next + q(x[i])*width;
+            upper_diag[i]   = -p_next/h_next;
+            rhs_val[i]      = f(x[i])*width;
+
+            h_prev = h_next;
+            p_prev = p_next;
+        }
+
+        if (right.beta == 0)
+        {   // Dirichlet
+            lower_diag[last-1] = 0;
+            diag[last]         = 1;
+            rhs_val[last]      = right.gamma/right.alpha;
+        }
+        else
+        {   // half control volume with the flux p*u' = p*(gamma - alpha*u)/beta
+            double p_end       = p(x[last]);
+            lower_diag[last-1] = -p_prev/h_prev;
+            diag[last]         = p_prev/h_prev + p_end*right.alpha/right.beta
+                               + q(x[last])*h_prev/2;
+            rhs_val[last]      = f(x[last])*h_prev/2 + p_end*right.gamma/right.beta;
+        }
+    }
+
+    void solve(double* computed)
+    {   /*
+        Solves the last assembled system.
+
+        Parameters
+        ----------
+        computed : double*
+            Buffer where the solution u(x_i) at all num_points grid points is
+            stored.
+        */
+        solve_tridiagonal(n, lower_diag.data(), diag.data(), upper_diag.data(),
+            rhs_val.data(), computed, work.data());
+    }
+
+    template <class P, class Q, class F>
+    void solve(int num_points, const double* x, P p, Q q, F f,
+        BoundaryCondition left, BoundaryCondition right, double* computed)
+    {   /*
+        Assembles and solves in one call. See assemble for the parameters.
+
+        computed : double*
+            Buffer where the solution u(x_i) at all num_points grid points is
+            stored.
+        */
+        assemble(num_points, x, p, q, f, left, right);
+        solve(computed);
+    }
+
+    int size() const
+    {
+        return n;
+    }
+};
+
+#endif
@@ -0,0 +1,127 @@
+#ifndef NPY_FILE_H
+#define NPY_FILE_H
+
+#include <cstring>
+#include <iostream>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+
+class NpyFile
+{
+    /*
+    Memory-mapped .npy file holding a C-ordered 2D array of doubles in the
+    byte order of the machine. The file is created with its final size when
+    the object is constructed, the values are written directly into the
+    mapping through data(), and the mapping is flushed and closed when the
+    object goes out of scope. No buffers are allocated besides the mapping.
+
+    The file is read zero-copy from Python with np.load(filename, mmap_mode="r").
+    */
+private:
+    int fd          = -1;
+    char* mapping   = nullptr;
+    size_t map_size = 0;
+    size_t offset   = 0;    // size of the .npy header, multiple of 64 bytes
+
+public:
+    NpyFile(std::string filename, long rows, long cols)
+    {   /*
+        Creates (or overwrites) the file and maps it into memory.
+
+        Parameters
+        ----------
+        filename : std::string
+            Filename of the output file, should end with .npy.
+
+        rows : long
+            Number of rows of the array.
+
+        cols : long
+            Number of columns of the array.
+        */
+
+        #if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        std::string descr = ">f8";
+        #else
+        std::string descr = "<f8";
+        #endif
+
+        std::string header = "{'descr': '" + descr + "', 'fortran_order': False, "
+            "'shape': (" + std::to_string(rows) + ", " + std::to_string(cols) + "), }";
+
+        // magic string (6) + version (2) + header length (2) + header + '\n',
+        // padded with spaces so that the data starts at a multiple of 64 bytes
+        size_t preamble = 10;
+        size_t padding  = 64 - (preamble + header.size() + 1)%64;
+        header += std::string(padding%64, ' ') + "\n";
+        offset = preamble + header.size();
+        map_size = offset + sizeof(double)*rows*cols;
+
+        fd = open(filename.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if ((fd < 0) || (ftruncate(fd, map_size) != 0))
+        {
+            std::cout << "could not create " << filename << std::endl;
+            close_file();
+            return;
+        }
+
+        void* ptr = mmap(nullptr, map_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (ptr == MAP_FAILED)
+        {
+            std::cout << "could not map " << filename << std::endl;
+            close_file();
+            return;
+        }
+        mapping = static_cast<char*>(ptr);
+
+        unsigned short header_len = header.size();
+        std::memcpy(mapping, "\x93NUMPY\x01\x00", 8);
+        mapping[8] = header_len & 0xff;     // little-endian by specification
+        mapping[9] = header_len >> 8;
+        std::memcpy(mapping + preamble, header.data(), header.size());
+    }
+
+    double* data()
+    {   /*
+        Pointer to the first value of the array, or nullptr if the file could
+        not be created.
+        */
+        return mapping ? reinterpret_cast<double*>(mapping + offset) : nullptr;
+    }
+
+    bool is_open() const
+    {
+        return mapping != nullptr;
+    }
+
+    void close_file()
+    {   /*
+        Unmaps and closes the file. Called by the destructor.
+        */
+        if (mapping)
+        {
+            munmap(mapping, map_size);
+            mapping = nullptr;
+        }
+
+        if (fd >= 0)
+        {
+            close(fd);
+            fd = -1;
+        }
+    }
+
+    NpyFile(const NpyFile&) = delete;
+    NpyFile& operator=(const NpyFile&) = delete;
+
+    ~NpyFile()
+    {
+        close_file();
+    }
+};
+
+#endif
@@ -0,0 +1,198 @@
+#ifndef POISSON_PROBLEM_H
+#define POISSON_PROBLEM_H
+
+#include <algorithm>
+#include <cmath>
+
+
+/*
+The right-hand side f(x) = 100e^(-10x) and the exact solution
+u(x) = 1 - (1 - e^(-10))x - e^(-10x) of -u'' = f on [0, 1] with u(0) = u(1) = 0,
+evaluated on the uniform grid x_i = h(i+1), i = 0, 1, ..., n-1, h = 1/(n+1).
+
+Both only need e^(-10x_i). The array versions evaluate it in blocks of
+exp_block points, with one exp call per block multiplied by a table of
+e^(-10hk), k = 0, 1, ..., exp_block-1. The multiplications vectorize, and
+the blocks keep the error within a couple of ulp, unlike a recurrence over
+all points where the error grows with n.
+*/
+
+const int exp_block = 64;   // number of points per exp call
+
+
+inline double rhs_func(double x)
+{
+    /*
+    Function for calculating the right-hand-side of the equation, i.e.,
+    f(x) = 100e^(-10x).
+
+    Parameters
+    ----------
+    x : double
+        Function variable.
+    */
+    return 100*std::exp(-10*x);
+}
+
+inline double exact_solution(double x)
+{
+    /*
+    Function for calculating the exact solution to our numerical problem. This will
+    be used for comparing the numerical precision for our computed solution.
+
+    Parameters
+    ----------
+    x : double
+        Function variable.
+    */
+    return 1 - (1 - std::exp(-10))*x - std::exp(-10*x);
+}
+
+inline void fill_exp_powers(int n, double stepsize, double* powers)
+{
+    /*
+    Table of e^(-10hk), k = 0, 1, ..., min(n, exp_block)-1.
+
+    Parameters
+    ----------
+    n : int
+        Number of grid points.
+
+    stepsize : double
+        Grid spacing h.
+
+    powers : double*
+        Output array of length exp_block.
+    */
+    int len = std::min(n, exp_block);
+    for (int k=0; k<len; k++)
+    {
+        powers[k] = std::exp(-10*stepsize*k);
+    }
+}
+
+inline void fill_exp_grid(int n, double* exp_val)
+{
+    /*
+    Calculates e^(-10x_i) for all grid points.
+
+    Parameters
+    ----------
+    n : int
+        Number of grid points.
+
+    exp_val : double*
+        Output array of length n.
+    */
+    double stepsize = 1.0/(n+1);
+    double powers[exp_block];
+    fill_exp_powers(n, stepsize, powers);
+
+    for (int start=0; start<n; start+=exp_block)
+    {   // one exp call per block
+        double base = std::exp(-10*stepsize*(start+1));
+        int len     = std::min(exp_block, n - start);
+        double* out = exp_val + start;
+
+        #pragma omp simd
+        for (int k=0; k<len; k++)
+        {
+            out[k] = base*powers[k];
+        }
+    }
+}
+
+inline void fill_rhs(int n, double* rhs_val)
+{
+    /*
+    Calculates the r.h.s. of the linear system, h^2 f(x_i), for all grid
+    points.
+
+    Parameters
+    ----------
+    n : int
+        Number of grid points.
+
+    rhs_val : double*
+        Output array of length n.
+    */
+    double stepsize = 1.0/(n+1);
+    double scale    = 100*stepsize*stepsize;
+
+    fill_exp_grid(n, rhs_val);
+
+    #pragma omp simd
+    for (int i=0; i<n; i++)
+    {
+        rhs_val[i] *= scale;
+    }
+}
+
+inline void fill_exact(int n, double* exact_val)
+{
+    /*
+    Calculates the exact solution u(x_i) for all grid points.
+
+    Parameters
+    ----------
+    n : int
+        Number of grid points.
+
+    exact_val : double*
+        Output array of length n.
+    */
+    double stepsize = 1.0/(n+1);
+    double slope    = 1 - std::exp(-10);
+
+    fill_exp_grid(n, exact_val);
+
+    #pragma omp simd
+    for (int i=0; i<n; i++)
+    {
+        exact_val[i] = 1 - slope*(stepsize*(i+1)) - exact_val[i];
+    }
+}
+
+
+class ExactSolution
+{
+    /*
+    The exact solution as a function of the grid index, exact(i) = u(x_i), for
+    the fused error kernels and writers which need one value at a time. The
+    e^(-10x) of the current block is kept, so walking through the grid in
+    either direction costs one exp call per exp_block points, and needs no
+    array of length n.
+    */
+private:
+    double stepsize;
+    double slope;
+    double base;
+    int block = -1;
+    double powers[exp_block];
+
+public:
+    ExactSolution(int n)
+    {   /*
+        Parameters
+        ----------
+        n : int
+            Number of grid points.
+        */
+        stepsize = 1.0/(n+1);
+        slope    = 1 - std::exp(-10);
+        fill_exp_powers(n, stepsize, powers);
+    }
+
+    double operator()(int i)
+    {
+        int current = i/exp_block;
+        if (current != block)
+        {   // entering a new block
+            block = current;
+            base  = std::exp(-10*stepsize*(block*exp_block + 1));
+        }
+        return 1 - slope*(stepsize*(i+1)) - base*powers[i - block*exp_block];
+    }
+};
+
+#endif
@@ -0,0 +1,197 @@
+#ifndef SWEEP_DRIVER_H
+#define SWEEP_DRIVER_H
+
+#include <algorithm>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "../../common/benchmark.h"
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+
+class SweepDriver
+{
+    /*
+    Thread pool for parameter sweeps where every work item is independent,
+    e.g., one (algorithm, n, repetition) combination. The items are dealt
+    round-robin to one queue per worker. A worker takes items from the front
+    of its own queue, and when the queue is empty it steals from the back of
+    the queues of the other workers, so that a few expensive items at the end
+    do not leave the other workers idle.
+
+    Each worker is pinned to its own core among the cores the process may run
+    on, and runs one item at a time, so a timing measured inside an item is
+    not disturbed by other items on the same core. The results are returned
+    in item order, independent of which worker ran which item.
+    */
+private:
+    int num_threads;
+    bool pin;
+
+    struct WorkQueue
+    {
+        std::mutex lock;
+        std::deque<int> items;
+    };
+
+    static std::vector<int> allowed_cores()
+    {   /*
+        The cores the process may run on, or an empty vector if the affinity
+        is not available.
+        */
+        std::vector<int> cores;
+        #ifdef __linux__
+        cpu_set_t set;
+        CPU_ZERO(&set);
+
+        if (sched_getaffinity(0, sizeof(set), &set) == 0)
+        {
+            for (int i=0; i<CPU_SETSIZE; i++)
+            {
+                if (CPU_ISSET(i, &set)) cores.push_back(i);
+            }
+        }
+        #endif
+        return cores;
+    }
+
+    static bool next_item(std::vector<WorkQueue>& queues, int worker, int& item)
+    {   /*
+        Takes the next item from the front of the worker's own queue, or steals
+        one from the back of another queue. Returns false when all queues are
+        empty.
+        */
+        int num_queues = queues.size();
+
+        for (int i=0; i<num_queues; i++)
+        {   // own queue first, then the other queues in turn
+            int victim = (worker + i)%num_queues;
+            std::lock_guard<std::mutex> guard(queues[victim].lock);
+
+            if (queues[victim].items.empty()) continue;
+
+            if (i == 0)
+            {
+                item = queues[victim].items.front();
+                queues[victim].items.pop_front();
+            }
+            else
+            {
+                item = queues[victim].items.back();
+                queues[victim].items.pop_back();
+            }
+            return true;
+        }
+        return false;
+    }
+
+public:
+    SweepDriver(int num_threads_input = 0, bool pin_input = true)
+    {   /*
+        Parameters
+        ----------
+        num_threads_input : int
+            Number of worker threads. Defaults to one per core the process may
+            run on.
+
+        pin_input : bool
+            Boolean for toggling pinning of the workers to cores on/off.
+        */
+        int cores = allowed_cores().size();
+        if (cores == 0) cores = std::max(1u, std::thread::hardware_concurrency());
+
+        num_threads = (num_threads_input > 0) ? num_threads_input : cores;
+        pin = pin_input;
+    }
+
+    int threads() const
+    {
+        return num_threads;
+    }
+
+    template <class F>
+    auto run(int num_items, F task) -> std::vector<decltype(task(0, 0))>
+    {   /*
+        Runs task(item, worker) for item = 0, 1, ..., num_items - 1 on the
+        worker threads.
+
+        Parameters
+        ----------
+        num_items : int
+            Number of work items.
+
+        task : callable
+            Called as task(item, worker) where 'worker' is the index of the
+            worker thread, 0 <= worker < threads(), which can be used to select
+            per-worker buffers. Must be safe to call concurrently for different
+            items.
+
+        Returns
+        -------
+        results : std::vector
+            The return value of task for each item, in item order. If a task
+            throws, the first exception is rethrown after all workers are done.
+        */
+
+        typedef decltype(task(0, 0)) Result;
+        std::vector<Result> results(num_items);
+
+        int workers = std::max(1, std::min(num_threads, num_items));
+        std::vector<WorkQueue> queues(workers);
+
+        for (int item=0; item<num_items; item++)
+        {   // dealing the items round-robin
+            queues[item%workers].items.push_back(item);
+        }
+
+        std::vector<int> cores = allowed_cores();
+        std::exception_ptr error = nullptr;
+        std::mutex error_lock;
+
+        auto work = [&](int worker)
+        {
+            if (pin && !cores.empty())
+            {
+                Benchmark::pin_to_core(cores[worker%cores.size()]);
+            }
+
+            int item;
+            while (next_item(queues, worker, item))
+            {
+                try
+                {
+                    results[item] = task(item, worker);
+                }
+                catch (...)
+                {
+                    std::lock_guard<std::mutex> guard(error_lock);
+                    if (!error) error = std::current_exception();
+                }
+            }
+        };
+
+        // the calling thread only waits, so that its affinity (which is
+        // inherited by OpenMP threads started later) is left unchanged
+        std::vector<std::thread> pool;
+        for (int worker=0; worker<workers; worker++)
+        {
+            pool.emplace_back(work, worker);
+        }
+
+        for (std::thread& thread : pool)
+        {
+            thread.join();
+        }
+
+        if (error) std::rethrow_exception(error);
+
+        return results;
+    }
+};
+
+#endif
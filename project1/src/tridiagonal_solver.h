@@ -0,0 +1,981 @@
+#ifndef TRIDIAGONAL_SOLVER_H
+#define TRIDIAGONAL_SOLVER_H
+
+#include <vector>
+#include <algorithm>
+#include <cmath>
+
+
+inline void solve_tridiagonal(int n, const double* lower_diag, const double* diag,
+    const double* upper_diag, const double* rhs_val, double* computed,
+    double* work)
+{
+    /*
+    Thomas algorithm for a general tridiagonal matrix. All buffers are owned by
+    the caller and no memory is allocated, so the function can be called in
+    tight loops. None of the input buffers are modified, and rhs_val may be the
+    same pointer as computed for an in-place solve.
+
+    Parameters
+    ----------
+    n : int
+        Dimension of matrix. Number of discrete points.
+
+    lower_diag : const double*
+        Lower diagonal elements, n-1 values. lower_diag[i] is element (i+1, i).
+
+    diag : const double*
+        Diagonal elements, n values.
+
+    upper_diag : const double*
+        Upper diagonal elements, n-1 values. upper_diag[i] is element (i, i+1).
+
+    rhs_val : const double*
+        Right-hand-side values, n values.
+
+    computed : double*
+        Buffer of n values where the solution is stored.
+
+    work : double*
+        Scratch buffer of n values.
+    */
+
+    double denom = diag[0];
+    computed[0]  = rhs_val[0]/denom;
+
+    for (int i=1; i<n; i++)
+    {   // elimination of bottom diagonal by forward substitution
+        work[i-1]   = upper_diag[i-1]/denom;
+        denom       = diag[i] - lower_diag[i-1]*work[i-1];
+        computed[i] = (rhs_val[i] - lower_diag[i-1]*computed[i-1])/denom;
+    }
+
+    for (int i=n-2; i>=0; i--)
+    {   // elimination of top diagonal by backwards substitution
+        computed[i] = computed[i] - work[i]*computed[i+1];
+    }
+}
+
+
+template <int N>
+struct TridiagSolver
+{
+    /*
+    Thomas algorithm for a general tridiagonal matrix with a dimension N known
+    at compile time. The loop bounds are constants, so the compiler unrolls
+    the sweeps and keeps the scratch values in a stack array instead of a
+    caller-owned buffer. This pays off for small grids, where the loop
+    overhead and the runtime n are a large part of the solve. Use
+    solve_tridiagonal_dispatch to pick an instance from a runtime n.
+    */
+    static void solve(const double* lower_diag, const double* diag,
+        const double* upper_diag, const double* rhs_val, double* computed)
+    {   /*
+        Same arguments as solve_tridiagonal, without n and work.
+        */
+        double work[N];
+
+        double denom = diag[0];
+        computed[0]  = rhs_val[0]/denom;
+
+        #pragma GCC unroll 8
+        for (int i=1; i<N; i++)
+        {   // elimination of bottom diagonal by forward substitution
+            work[i-1]   = upper_diag[i-1]/denom;
+            denom       = diag[i] - lower_diag[i-1]*work[i-1];
+            computed[i] = (rhs_val[i] - lower_diag[i-1]*computed[i-1])/denom;
+        }
+
+        #pragma GCC unroll 8
+        for (int i=N-2; i>=0; i--)
+        {   // elimination of top diagonal by backwards substitution
+            computed[i] = computed[i] - work[i]*computed[i+1];
+        }
+    }
+};
+
+inline void solve_tridiagonal_dispatch(int n, const double* lower_diag,
+    const double* diag, const double* upper_diag, const double* rhs_val,
+    double* computed, double* work)
+{
+    /*
+    Same as solve_tridiagonal, but uses the compile-time instance
+    TridiagSolver<n> if one is compiled for this n, i.e., n = 10, 100 or 500.
+    To specialize for another grid size, add a case below.
+    */
+    switch (n)
+    {
+        case 10:  TridiagSolver<10>::solve(lower_diag, diag, upper_diag, rhs_val, computed);  return;
+        case 100: TridiagSolver<100>::solve(lower_diag, diag, upper_diag, rhs_val, computed); return;
+        case 500: TridiagSolver<500>::solve(lower_diag, diag, upper_diag, rhs_val, computed); return;
+        default:  solve_tridiagonal(n, lower_diag, diag, upper_diag, rhs_val, computed, work);
+    }
+}
+
+
+template <class Exact>
+inline double solve_tridiagonal_max_rel_error(int n, const double* lower_diag,
+    const double* diag, const double* upper_diag, const double* rhs_val,
+    double* computed, double* work, Exact exact)
+{
+    /*
+    Same as solve_tridiagonal, but the maximum relative error against a known
+    exact solution is accumulated during the backward substitution, so no
+    second pass over the solution is needed.
+
+    Parameters
+    ----------
+    n, lower_diag, diag, upper_diag, rhs_val, computed, work :
+        See solve_tridiagonal.
+
+    exact : callable
+        exact(i) returns the exact solution at point i as a double.
+
+    Returns
+    -------
+    max_rel_error : double
+        Maximum of |computed[i] - exact(i)|/|exact(i)| over all points.
+    */
+
+    double denom = diag[0];
+    computed[0]  = rhs_val[0]/denom;
+
+    for (int i=1; i<n; i++)
+    {   // elimination of bottom diagonal by forward substitution
+        work[i-1]   = upper_diag[i-1]/denom;
+        denom       = diag[i] - lower_diag[i-1]*work[i-1];
+        computed[i] = (rhs_val[i] - lower_diag[i-1]*computed[i-1])/denom;
+    }
+
+    double exact_val     = exact(n-1);
+    double max_rel_error = std::fabs((computed[n-1] - exact_val)/exact_val);
+
+    for (int i=n-2; i>=0; i--)
+    {   // elimination of top diagonal by backwards substitution
+        computed[i] = computed[i] - work[i]*computed[i+1];
+        exact_val   = exact(i);
+        max_rel_error = std::max(max_rel_error,
+            std::fabs((computed[i] - exact_val)/exact_val));
+    }
+
+    return max_rel_error;
+}
+
+
+inline void solve_tridiagonal_constant(int n, double lower_diag, double diag,
+    double upper_diag, const double* rhs_val, double* computed, double* work)
+{
+    /*
+    Thomas algorithm for a tridiagonal matrix with constant values along each
+    of the three diagonals. Same buffer conventions as solve_tridiagonal.
+
+    Parameters
+    ----------
+    n : int
+        Dimension of matrix. Number of discrete points.
+
+    lower_diag : double
+        Value of the lower diagonal elements.
+
+    diag : double
+        Value of the diagonal elements.
+
+    upper_diag : double
+        Value of the upper diagonal elements.
+
+    rhs_val : const double*
+        Right-hand-side values, n values.
+
+    computed : double*
+        Buffer of n values where the solution is stored.
+
+    work : double*
+        Scratch buffer of n values.
+    */
+
+    double denom = diag;
+    computed[0]  = rhs_val[0]/denom;
+
+    for (int i=1; i<n; i++)
+    {   // forward substitution
+        work[i-1]   = upper_diag/denom;
+        denom       = diag - lower_diag*work[i-1];
+        computed[i] = (rhs_val[i] - lower_diag*computed[i-1])/denom;
+    }
+
+    for (int i=n-2; i>=0; i--)
+    {   // backward substitution
+        computed[i] = computed[i] - work[i]*computed[i+1];
+    }
+}
+
+
+inline void solve_tridiagonal_toeplitz(int n, double off_diag, double diag,
+    const double* rhs_val, double* computed, double* work)
+{
+    /*
+    Thomas algorithm for a symmetric Toeplitz tridiagonal matrix, i.e., equal
+    upper and lower diagonal elements. The (-1, 2, -1) matrix of the Poisson
+    problem is of this kind.
+
+    Parameters
+    ----------
+    n : int
+        Dimension of matrix. Number of discrete points.
+
+    off_diag : double
+        Value of the upper and lower diagonal elements.
+
+    diag : double
+        Value of the diagonal elements.
+
+    rhs_val : const double*
+        Right-hand-side values, n values.
+
+    computed : double*
+        Buffer of n values where the solution is stored.
+
+    work : double*
+        Scratch buffer of n values.
+    */
+
+    solve_tridiagonal_constant(n, off_diag, diag, off_diag, rhs_val, computed,
+        work);
+}
+
+
+inline void solve_tridiagonal_batched(int n, int batch, const double* lower_diag,
+    const double* diag, const double* upper_diag, const double* rhs_val,
+    double* computed, double* work)
+{
+    /*
+    Thomas algorithm for 'batch' independent tridiagonal systems of the same
+    dimension, stored interleaved (structure of arrays) so that element i of
+    system k is found at index i*batch + k. The recurrence is still serial in
+    i, but the inner loop over the systems has no dependencies and is
+    vectorized by the compiler (compile with -O3 -march=native -fopenmp-simd
+    to get AVX2/AVX-512 code).
+
+    Parameters
+    ----------
+    n : int
+        Dimension of each matrix.
+
+    batch : int
+        Number of systems.
+
+    lower_diag : const double*
+        Lower diagonal elements, (n-1)*batch values.
+
+    diag : const double*
+        Diagonal elements, n*batch values.
+
+    upper_diag : const double*
+        Upper diagonal elements, (n-1)*batch values.
+
+    rhs_val : const double*
+        Right-hand-side values, n*batch values.
+
+    computed : double*
+        Buffer of n*batch values where the solutions are stored.
+
+    work : double*
+        Scratch buffer of n*batch values.
+    */
+
+    #pragma omp simd
+    for (int k=0; k<batch; k++)
+    {   // first row of every system
+        work[k]     = 1.0/diag[k];
+        computed[k] = rhs_val[k]*work[k];
+    }
+
+    for (int i=1; i<n; i++)
+    {   // forward substitution, work holds upper_diag/pivot of the previous row
+        const double* lower = lower_diag + (i-1)*batch;
+        const double* upper = upper_diag + (i-1)*batch;
+        const double* d     = diag       + i*batch;
+        const double* r     = rhs_val    + i*batch;
+        double* w_prev      = work       + (i-1)*batch;
+        double* w           = work       + i*batch;
+        double* x_prev      = computed   + (i-1)*batch;
+        double* x           = computed   + i*batch;
+
+        #pragma omp simd
+        for (int k=0; k<batch; k++)
+        {   // w_prev holds 1/pivot of the previous row on entry
+            w_prev[k]  = upper[k]*w_prev[k];
+            double inv = 1.0/(d[k] - lower[k]*w_prev[k]);
+            w[k]       = inv;
+            x[k]       = (r[k] - lower[k]*x_prev[k])*inv;
+        }
+    }
+
+    for (int i=n-2; i>=0; i--)
+    {   // backward substitution
+        const double* w      = work     + i*batch;
+        const double* x_next = computed + (i+1)*batch;
+        double* x            = computed + i*batch;
+
+        #pragma omp simd
+        for (int k=0; k<batch; k++)
+        {
+            x[k] = x[k] - w[k]*x_next[k];
+        }
+    }
+}
+
+
+inline long tridiagonal_parallel_work_size(int n, int num_blocks)
+{
+    /*
+    Number of doubles needed for the work buffer of solve_tridiagonal_parallel.
+
+    Parameters
+    ----------
+    n : int
+        Dimension of matrix.
+
+    num_blocks : int
+        Number of blocks the matrix is partitioned into.
+    */
+    return 4L*n + 6L*num_blocks;
+}
+
+
+inline void solve_tridiagonal_parallel(int n, const double* lower_diag,
+    const double* diag, const double* upper_diag, const double* rhs_val,
+    double* computed, double* work, int num_blocks)
+{
+    /*
+    Partitioned Thomas algorithm which solves the blocks of the matrix in
+    parallel with OpenMP (compile with -fopenmp).
+
+    The rows are split into num_blocks blocks separated by single separator
+    rows. Every block is solved independently with the Thomas algorithm for
+    three right-hand sides: the local right-hand side y, and the responses v
+    and w to the coupling with the separator to the left and right. The
+    solution inside block j is then
+
+        x_i = y_i - v_i*x_left - w_i*x_right,
+
+    and inserting this in the separator rows gives a small tridiagonal system
+    of num_blocks-1 unknowns, which is solved serially. Finally all blocks are
+    corrected in parallel. This costs about three times the flops of the
+    serial algorithm, but runs on num_blocks cores. Falls back to the serial
+    solver when the matrix is too small to partition.
+
+    Parameters
+    ----------
+    n : int
+        Dimension of matrix. Number of discrete points.
+
+    lower_diag : const double*
+        Lower diagonal elements, n-1 values. lower_diag[i] is element (i+1, i).
+
+    diag : const double*
+        Diagonal elements, n values.
+
+    upper_diag : const double*
+        Upper diagonal elements, n-1 values. upper_diag[i] is element (i, i+1).
+
+    rhs_val : const double*
+        Right-hand-side values, n values.
+
+    computed : double*
+        Buffer of n values where the solution is stored. Must not be the same
+        pointer as rhs_val.
+
+    work : double*
+        Scratch buffer of tridiagonal_parallel_work_size(n, num_blocks) values.
+
+    num_blocks : int
+        Number of blocks, normally the number of threads.
+    */
+
+    if (num_blocks > (n + 1)/2)
+    {   // every block needs at least one row besides the separators
+        num_blocks = (n + 1)/2;
+    }
+
+    if (num_blocks <= 1)
+    {
+        solve_tridiagonal(n, lower_diag, diag, upper_diag, rhs_val, computed,
+            work);
+        return;
+    }
+
+    int num_sep = num_blocks - 1;   // number of separator rows
+    int rows    = n - num_sep;      // rows inside the blocks
+
+    double* upper_piv = work;       // upper_diag/pivot inside each block
+    double* inv_piv   = work + n;   // 1/pivot inside each block
+    double* v         = work + 2*n; // response to the left separator
+    double* w         = work + 3*n; // response to the right separator
+    double* red_lower = work + 4*n;
+    double* red_diag  = red_lower + num_blocks;
+    double* red_upper = red_diag  + num_blocks;
+    double* red_rhs   = red_upper + num_blocks;
+    double* red_x     = red_rhs   + num_blocks;
+    double* red_work  = red_x     + num_blocks;
+
+    #pragma omp parallel for schedule(static)
+    for (int j=0; j<num_blocks; j++)
+    {   // independent Thomas algorithm inside each block
+        int start = j*(rows/num_blocks) + std::min(j, rows%num_blocks) + j;
+        int end   = start + rows/num_blocks + (j < rows%num_blocks ? 1 : 0) - 1;
+
+        double coupling_left  = (j > 0) ? lower_diag[start-1] : 0.0;
+        double coupling_right = (j < num_blocks-1) ? upper_diag[end] : 0.0;
+
+        inv_piv[start]  = 1.0/diag[start];
+        computed[start] = rhs_val[start]*inv_piv[start];
+        v[start]        = coupling_left*inv_piv[start];
+        w[start]        = 0.0;
+
+        for (int i=start+1; i<=end; i++)
+        {   // forward substitution for y, v and w at once
+            upper_piv[i-1] = upper_diag[i-1]*inv_piv[i-1];
+            inv_piv[i]     = 1.0/(diag[i] - lower_diag[i-1]*upper_piv[i-1]);
+            computed[i]    = (rhs_val[i] - lower_diag[i-1]*computed[i-1])*inv_piv[i];
+            v[i]           = -lower_diag[i-1]*v[i-1]*inv_piv[i];
+            w[i]           = 0.0;
+        }
+        w[end] = coupling_right*inv_piv[end];
+
+        for (int i=end-1; i>=start; i--)
+        {   // backward substitution for y, v and w at once
+            computed[i] = computed[i] - upper_piv[i]*computed[i+1];
+            v[i]        = v[i]        - upper_piv[i]*v[i+1];
+            w[i]        = w[i]        - upper_piv[i]*w[i+1];
+        }
+    }
+
+    for (int q=0; q<num_sep; q++)
+    {   // reduced system for the separator rows
+        int r = (q+1)*(rows/num_blocks) + std::min(q+1, rows%num_blocks) + q;
+
+        red_diag[q] = diag[r] - lower_diag[r-1]*w[r-1] - upper_diag[r]*v[r+1];
+        red_rhs[q]  = rhs_val[r] - lower_diag[r-1]*computed[r-1]
+                    - upper_diag[r]*computed[r+1];
+        
+        if (q > 0)
+        {
+            red_lower[q-1] = -lower_diag[r-1]*v[r-1];
+        }
+        
+        if (q < num_sep-1)
+        {
+            red_upper[q] = -upper_diag[r]*w[r+1];
+        }
+    }
+
+    solve_tridiagonal(num_sep, red_lower, red_diag, red_upper, red_rhs, red_x,
+        red_work);
+
+    #pragma omp parallel for schedule(static)
+    for (int j=0; j<num_blocks; j++)
+    {   // correcting each block with the separator values
+        int start = j*(rows/num_blocks) + std::min(j, rows%num_blocks) + j;
+        int end   = start + rows/num_blocks + (j < rows%num_blocks ? 1 : 0) - 1;
+
+        double x_left  = (j > 0) ? red_x[j-1] : 0.0;
+        double x_right = (j < num_blocks-1) ? red_x[j] : 0.0;
+
+        for (int i=start; i<=end; i++)
+        {
+            computed[i] = computed[i] - v[i]*x_left - w[i]*x_right;
+        }
+
+        if (j < num_blocks-1)
+        {
+            computed[end+1] = x_right;
+        }
+    }
+}
+
+
+class TridiagonalSolver
+{
+    /*
+    LU factorization of a tridiagonal matrix which is kept between solves.
+    The factorization stores the elimination multipliers and the reciprocal
+    pivots, so that every subsequent solve is two sweeps of multiplications
+    and subtractions without any divisions or allocations.
+
+    Memory is allocated in the constructor only. Calling factorize with a new
+    matrix of the same dimension reuses the buffers.
+    */
+private:
+    int n;
+    std::vector<double> multiplier;  // lower_diag[i]/pivot[i], n-1 values
+    std::vector<double> inv_pivot;   // 1/pivot[i], n values
+    std::vector<double> upper;       // upper diagonal, n-1 values
+
+public:
+    TridiagonalSolver(int n_input)
+    : n(n_input), multiplier(n_input), inv_pivot(n_input), upper(n_input)
+    {   /*
+        Allocates buffers for a matrix of dimension n_input. factorize must be
+        called before solve.
+
+        Parameters
+        ----------
+        n_input : int
+            Dimension of matrix.
+        */
+    }
+
+    TridiagonalSolver(int n_input, const double* lower_diag, const double* diag,
+        const double* upper_diag)
+    : TridiagonalSolver(n_input)
+    {   /*
+        Allocates buffers and factorizes a general tridiagonal matrix.
+
+        Parameters
+        ----------
+        n_input : int
+            Dimension of matrix.
+
+        lower_diag : const double*
+            Lower diagonal elements, n-1 values.
+
+        diag : const double*
+            Diagonal elements, n values.
+
+        upper_diag : const double*
+            Upper diagonal elements, n-1 values.
+        */
+        factorize(lower_diag, diag, upper_diag);
+    }
+
+    TridiagonalSolver(int n_input, double off_diag, double diag)
+    : TridiagonalSolver(n_input)
+    {   /*
+        Allocates buffers and factorizes a symmetric Toeplitz tridiagonal
+        matrix.
+
+        Parameters
+        ----------
+        n_input : int
+            Dimension of matrix.
+
+        off_diag : double
+            Value of the upper and lower diagonal elements.
+
+        diag : double
+            Value of the diagonal elements.
+        */
+        factorize(off_diag, diag);
+    }
+
+    void factorize(const double* lower_diag, const double* diag,
+        const double* upper_diag)
+    {   /*
+        Computes the LU factorization of a general tridiagonal matrix of the
+        dimension given in the constructor.
+
+        Parameters
+        ----------
+        lower_diag : const double*
+            Lower diagonal elements, n-1 values.
+
+        diag : const double*
+            Diagonal elements, n values.
+
+        upper_diag : const double*
+            Upper diagonal elements, n-1 values.
+        */
+
+        double pivot = diag[0];
+        inv_pivot[0] = 1.0/pivot;
+
+        for (int i=0; i<n-1; i++)
+        {   // eliminating the lower diagonal element of row i+1
+            multiplier[i]  = lower_diag[i]*inv_pivot[i];
+            upper[i]       = upper_diag[i];
+            pivot          = diag[i+1] - multiplier[i]*upper_diag[i];
+            inv_pivot[i+1] = 1.0/pivot;
+        }
+    }
+
+    void factorize(double off_diag, double diag)
+    {   /*
+        Computes the LU factorization of a symmetric Toeplitz tridiagonal
+        matrix of the dimension given in the constructor.
+
+        Parameters
+        ----------
+        off_diag : double
+            Value of the upper and lower diagonal elements.
+
+        diag : double
+            Value of the diagonal elements.
+        */
+
+        double pivot = diag;
+        inv_pivot[0] = 1.0/pivot;
+
+        for (int i=0; i<n-1; i++)
+        {   // eliminating the lower diagonal element of row i+1
+            multiplier[i]  = off_diag*inv_pivot[i];
+            upper[i]       = off_diag;
+            pivot          = diag - multiplier[i]*off_diag;
+            inv_pivot[i+1] = 1.0/pivot;
+        }
+    }
+
+    void solve(const double* rhs_val, double* computed) const
+    {   /*
+        Solves the factorized system for one right-hand side. rhs_val may be
+        the same pointer as computed.
+
+        Parameters
+        ----------
+        rhs_val : const double*
+            Right-hand-side values, n values.
+
+        computed : double*
+            Buffer of n values where the solution is stored.
+        */
+
+        computed[0] = rhs_val[0];
+        for (int i=0; i<n-1; i++)
+        {   // forward substitution
+            computed[i+1] = rhs_val[i+1] - multiplier[i]*computed[i];
+        }
+
+        computed[n-1] = computed[n-1]*inv_pivot[n-1];
+        for (int i=n-2; i>=0; i--)
+        {   // backward substitution
+            computed[i] = (computed[i] - upper[i]*computed[i+1])*inv_pivot[i];
+        }
+    }
+
+    int size() const
+    {
+        return n;
+    }
+};
+
+
+class PoissonSolver
+{
+    /*
+    Factorization of the (-1, 2, -1) matrix of the discretized Poisson
+    equation, kept between solves. The pivots of this matrix are
+    d_i = (i+2)/(i+1), which do not depend on the dimension n, so the
+    reciprocal pivots computed for one dimension are valid for every smaller
+    dimension as well. One object can therefore serve a whole set of grid
+    sizes, and a solve is two sweeps of multiplications and additions without
+    any divisions.
+
+    Memory is only allocated when the object is asked to serve a larger
+    dimension than before.
+    */
+private:
+    std::vector<double> inv_pivot;  // 1/d_i = (i+1)/(i+2)
+
+public:
+    PoissonSolver(int n_max = 0)
+    {   /*
+        Parameters
+        ----------
+        n_max : int
+            Largest dimension to factorize for. Defaults to 0, in which case
+            reserve must be called before solve.
+        */
+        reserve(n_max);
+    }
+
+    void reserve(int n_max)
+    {   /*
+        Extends the cached reciprocal pivots so that systems of dimension up
+        to n_max can be solved. Does nothing if they are already cached.
+
+        Parameters
+        ----------
+        n_max : int
+            Largest dimension to factorize for.
+        */
+
+        int n_old = inv_pivot.size();
+        if (n_max <= n_old)
+        {
+            return;
+        }
+
+        inv_pivot.resize(n_max);
+        for (int i=n_old; i<n_max; i++)
+        {   // closed form of diag[i+1] = 2 - 1/diag[i], inverted
+            inv_pivot[i] = (i + 1.0)/(i + 2.0);
+        }
+    }
+
+    void solve(int n, const double* rhs_val, double* computed) const
+    {   /*
+        Solves the (-1, 2, -1) system of dimension n. reserve(n) must have
+        been called. rhs_val may be the same pointer as computed.
+
+        Parameters
+        ----------
+        n : int
+            Dimension of matrix. Number of discrete points.
+
+        rhs_val : const double*
+            Right-hand-side values, n values.
+
+        computed : double*
+            Buffer of n values where the solution is stored.
+        */
+
+        const double* inv = inv_pivot.data();
+
+        computed[0] = rhs_val[0];
+        for (int i=0; i<n-1; i++)
+        {   // forward substitution
+            computed[i+1] = rhs_val[i+1] + computed[i]*inv[i];
+        }
+
+        computed[n-1] = computed[n-1]*inv[n-1];
+        for (int i=n-2; i>=0; i--)
+        {   // backward substitution
+            computed[i] = (computed[i] + computed[i+1])*inv[i];
+        }
+    }
+
+    template <class Exact>
+    double solve_max_rel_error(int n, const double* rhs_val, double* computed,
+        Exact exact) const
+    {   /*
+        Same as solve, but the maximum relative error against a known exact
+        solution is accumulated during the backward substitution.
+
+        Parameters
+        ----------
+        n, rhs_val, computed :
+            See solve.
+
+        exact : callable
+            exact(i) returns the exact solution at point i as a double.
+
+        Returns
+        -------
+        max_rel_error : double
+            Maximum of |computed[i] - exact(i)|/|exact(i)| over all points.
+        */
+
+        const double* inv = inv_pivot.data();
+
+        computed[0] = rhs_val[0];
+        for (int i=0; i<n-1; i++)
+        {   // forward substitution
+            computed[i+1] = rhs_val[i+1] + computed[i]*inv[i];
+        }
+
+        computed[n-1] = computed[n-1]*inv[n-1];
+        double exact_val     = exact(n-1);
+        double max_rel_error = std::fabs((computed[n-1] - exact_val)/exact_val);
+
+        for (int i=n-2; i>=0; i--)
+        {   // backward substitution
+            computed[i]   = (computed[i] + computed[i+1])*inv[i];
+            exact_val     = exact(i);
+            max_rel_error = std::max(max_rel_error,
+                std::fabs((computed[i] - exact_val)/exact_val));
+        }
+
+        return max_rel_error;
+    }
+
+    int max_size() const
+    {
+        return inv_pivot.size();
+    }
+};
+
+
+class MixedPrecisionSolver
+{
+    /*
+    Tridiagonal solver which does the elimination sweeps in single precision
+    and restores double precision accuracy with iterative refinement. The LU
+    factorization is stored in float, which halves the memory traffic of the
+    sweeps. Each refinement step computes the residual r = b - Ax in double,
+    solves A d = r with the float factorization and updates x += d. The
+    residual is computed inside the forward sweep of the correction, and the
+    update inside the backward sweep, so a refinement step is two passes over
+    the arrays.
+
+    The condition number of the (-1, 2, -1) matrix grows as n^2, so the
+    float solution gets worse with n, and so does the reduction per step.
+    Measured against the exact solution of the Poisson problem, with the
+    double Thomas algorithm in parentheses:
+
+        n = 10^5    two steps give 7.6e-10 (1.4e-9)
+        n = 10^6    two steps give 7.8e-8, about seven give 9.6e-10 (8.4e-7)
+        n = 10^7    two steps give 6.0e-4, ten give 3.0e-6 (3.0e-6)
+
+    So refinement pays off around n = 10^6, and gives nothing at 10^7. The
+    solver is always slower than the double Thomas algorithm, about 1.3
+    times for the float solve plus 0.6 times for every refinement step.
+    */
+private:
+    int n;
+    std::vector<float> multiplier;  // lower_diag[i]/pivot[i], n-1 values
+    std::vector<float> inv_pivot;   // 1/pivot[i], n values
+    std::vector<float> upper;       // upper diagonal, n-1 values
+    std::vector<float> work;        // forward sweep of the correction
+    int refinements = 0;            // refinement steps of the last solve
+
+public:
+    MixedPrecisionSolver(int n_input)
+    : n(n_input), multiplier(n_input), inv_pivot(n_input), upper(n_input),
+      work(n_input)
+    {   /*
+        Allocates buffers for a matrix of dimension n_input. factorize must be
+        called before solve.
+
+        Parameters
+        ----------
+        n_input : int
+            Dimension of matrix.
+        */
+    }
+
+    void factorize(const double* lower_diag, const double* diag,
+        const double* upper_diag)
+    {   /*
+        LU factorization of a general tridiagonal matrix. The pivots are
+        computed in double and rounded to float when stored.
+
+        Parameters
+        ----------
+        lower_diag : const double*
+            Lower diagonal elements, n-1 values.
+
+        diag : const double*
+            Diagonal elements, n values.
+
+        upper_diag : const double*
+            Upper diagonal elements, n-1 values.
+        */
+
+        double pivot = diag[0];
+        inv_pivot[0] = 1/pivot;
+
+        for (int i=1; i<n; i++)
+        {
+            double m        = lower_diag[i-1]/pivot;
+            pivot           = diag[i] - m*upper_diag[i-1];
+            multiplier[i-1] = m;
+            upper[i-1]      = upper_diag[i-1];
+            inv_pivot[i]    = 1/pivot;
+        }
+    }
+
+    void solve(const double* lower_diag, const double* diag,
+        const double* upper_diag, const double* rhs_val, double* computed,
+        int max_refinements = 2, double tolerance = 1e-14)
+    {   /*
+        Solves the system with refinement until the largest correction,
+        relative to the largest solution value, is below 'tolerance', is not
+        at least halved by a step, or 'max_refinements' steps are done.
+
+        Parameters
+        ----------
+        lower_diag, diag, upper_diag : const double*
+            The same matrix as given to factorize, in double precision, used
+            for the residual.
+
+        rhs_val : const double*
+            Right-hand-side values, n values. Must not be the same pointer as
+            computed.
+
+        computed : double*
+            Buffer of n values where the solution is stored.
+
+        max_refinements : int
+            Upper limit for the number of refinement steps.
+
+        tolerance : double
+            Relative size of the correction where the refinement stops.
+        */
+
+        const float* m   = multiplier.data();
+        const float* inv = inv_pivot.data();
+        const float* up  = upper.data();
+        float* y         = work.data();
+
+        y[0] = rhs_val[0];
+        for (int i=1; i<n; i++)
+        {   // forward substitution in float
+            y[i] = (float)rhs_val[i] - m[i-1]*y[i-1];
+        }
+
+        float x = y[n-1]*inv[n-1];
+        computed[n-1] = x;
+        double max_val = std::fabs(x);
+        for (int i=n-2; i>=0; i--)
+        {   // backward substitution in float
+            x = (y[i] - up[i]*x)*inv[i];
+            computed[i] = x;
+            max_val = std::max(max_val, std::fabs((double)x));
+        }
+
+        double last_correction = max_val;
+        refinements = 0;
+
+        while (refinements < max_refinements)
+        {
+            refinements++;
+
+            if (n == 1)
+            {   // no sweeps, only the residual of the single equation
+                computed[0] += (rhs_val[0] - diag[0]*computed[0])/diag[0];
+                break;
+            }
+
+            y[0] = rhs_val[0] - diag[0]*computed[0] - upper_diag[0]*computed[1];
+            for (int i=1; i<n-1; i++)
+            {   // double residual and forward substitution of the correction
+                double r = rhs_val[i] - lower_diag[i-1]*computed[i-1]
+                         - diag[i]*computed[i] - upper_diag[i]*computed[i+1];
+                y[i] = (float)r - m[i-1]*y[i-1];
+            }
+            double r = rhs_val[n-1] - lower_diag[n-2]*computed[n-2]
+                     - diag[n-1]*computed[n-1];
+            y[n-1] = (float)r - m[n-2]*y[n-2];
+
+            float d = y[n-1]*inv[n-1];
+            computed[n-1] += d;
+            double correction = std::fabs(d);
+            for (int i=n-2; i>=0; i--)
+            {   // backward substitution of the correction and update
+                d = (y[i] - up[i]*d)*inv[i];
+                computed[i] += d;
+                correction = std::max(correction, std::fabs((double)d));
+            }
+
+            if ((correction <= tolerance*max_val) || (2*correction > last_correction))
+            {   // converged, or another step would not improve much
+                break;
+            }
+            last_correction = correction;
+        }
+    }
+
+    int last_refinements() const
+    {   /*
+        Number of refinement steps done by the last call to solve.
+        */
+        return refinements;
+    }
+
+    int size() const
+    {
+        return n;
+    }
+};
+
+#endif
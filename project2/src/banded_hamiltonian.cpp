@@ -0,0 +1,561 @@
+#include "banded_hamiltonian.h"
+
+extern "C" void dsbevx_(char* jobz, char* range, char* uplo, int* n, int* kd,
+    double* ab, int* ldab, double* q, int* ldq, double* vl, double* vu, int* il,
+    int* iu, double* abstol, int* m, double* w, double* z, int* ldz, double* work,
+    int* iwork, int* ifail, int* info, size_t jobz_len, size_t range_len,
+    size_t uplo_len);
+
+extern "C" void dsbgvx_(char* jobz, char* range, char* uplo, int* n, int* ka,
+    int* kb, double* ab, int* ldab, double* bb, int* ldbb, double* q, int* ldq,
+    double* vl, double* vu, int* il, int* iu, double* abstol, int* m, double* w,
+    double* z, int* ldz, double* work, int* iwork, int* ifail, int* info,
+    size_t jobz_len, size_t range_len, size_t uplo_len);
+
+extern "C" void dgbtrf_(int* m, int* n, int* kl, int* ku, double* ab, int* ldab,
+    int* ipiv, int* info);
+
+extern "C" void dgbtrs_(char* trans, int* n, int* kl, int* ku, int* nrhs,
+    double* ab, int* ldab, int* ipiv, double* b, int* ldb, int* info,
+    size_t trans_len);
+
+
+static std::vector<double> stencil_coefficients(int order)
+{
+    /*
+    Central difference coefficients c_0, c_1, ... of -h^2 u'', such that
+    -u''(x_i) = (c_0 u_i + sum_k c_k (u_(i-k) + u_(i+k)))/h^2 + O(h^order).
+    */
+
+    if (order == 2) return {2.0, -1.0};
+    if (order == 4) return {30.0/12, -16.0/12, 1.0/12};
+    if (order == 6) return {490.0/180, -270.0/180, 27.0/180, -2.0/180};
+
+    throw std::invalid_argument("no stencil of order " + std::to_string(order));
+}
+
+
+int stencil_bandwidth(int order)
+{
+    /*
+    Number of super-diagonals of the Hamiltonian of a stencil, 1, 2 and 3
+    for the 3, 5 and 7-point stencils of order 2, 4 and 6.
+    */
+    return stencil_coefficients(order).size() - 1;
+}
+
+
+arma::mat stencil_hamiltonian(int n, double step, const arma::vec& potential, int order)
+{
+    /*
+    Hamiltonian -u'' + V u of the radial equation with u(0) = u(rho_max) = 0
+    on the grid rho_i = (i + 1)*step, i = 0, ..., n-1, step = rho_max/(n + 1),
+    with the central difference stencil of the given order. The wider
+    stencils reach past rho = 0, where u is continued as an odd function,
+    u(-rho) = -u(rho), which keeps the matrix symmetric and is exact for the
+    harmonic oscillator. Past rho_max, u is taken to be zero.
+
+    Parameters
+    ----------
+    n : int
+        Number of grid points.
+
+    step : double
+        Step size.
+
+    potential : const arma::vec&
+        V at the grid points, n values.
+
+    order : int
+        Order of the stencil, 2, 4 or 6.
+
+    Returns
+    -------
+    band : arma::mat
+        The upper triangle in LAPACK band storage, a (b + 1) x n matrix with
+        band(b + i - j, j) = H(i, j) for j - b <= i <= j, where b is
+        stencil_bandwidth(order).
+    */
+
+    std::vector<double> c = stencil_coefficients(order);
+    int b = c.size() - 1;
+    double h2 = step*step;
+
+    arma::mat band(b + 1, n);
+    band.zeros();
+
+    for (int j = 0; j < n; j++)
+    {
+        band(b, j) = c[0]/h2 + potential(j);
+        for (int k = 1; k <= b; k++)
+        {
+            if (j - k >= 0) band(b - k, j) = c[k]/h2;
+        }
+    }
+
+    for (int i = 0; i < b; i++)
+    {   // the odd continuation, u at index i - k < -1 is -u at index k - i - 2
+        for (int k = i + 2; k <= b; k++)
+        {
+            int j = k - i - 2;
+            if ((j >= i) && (j < n))
+            {
+                band(b + i - j, j) -= c[k]/h2;
+            }
+        }
+    }
+
+    return band;
+}
+
+
+void numerov_hamiltonian(int n, double step, const arma::vec& potential,
+    arma::mat& A, arma::mat& M)
+{
+    /*
+    Numerov's method for -u'' + V u = E u on the grid of stencil_hamiltonian,
+
+        (T/h^2 + B V) u = E B u,    T = tridiag(-1, 2, -1),
+                                    B = tridiag(1, 10, 1)/12,
+
+    which is of order 4 with a three-point stencil. B V is not symmetric, but
+    with u = B w the problem becomes
+
+        (T B/h^2 + B V B) w = E B^2 w,
+
+    since T and B commute, which is a symmetric-definite generalized problem
+    with bandwidth 2. The eigenvalues are the same, and the eigenvectors are
+    u = B w.
+
+    Parameters
+    ----------
+    n : int
+        Number of grid points.
+
+    step : double
+        Step size.
+
+    potential : const arma::vec&
+        V at the grid points, n values.
+
+    A : arma::mat&
+        T B/h^2 + B V B in the band storage of stencil_hamiltonian, 3 x n.
+
+    M : arma::mat&
+        B^2 in the same storage.
+    */
+
+    double h2 = step*step;
+
+    auto t = [](int i, int j) { return (i == j) ? 2.0 : ((std::abs(i - j) == 1) ? -1.0 : 0.0); };
+    auto b = [](int i, int j) { return (i == j) ? 10.0/12 : ((std::abs(i - j) == 1) ? 1.0/12 : 0.0); };
+
+    A.set_size(3, n);
+    M.set_size(3, n);
+    A.zeros();
+    M.zeros();
+
+    for (int j = 0; j < n; j++)
+    {
+        for (int i = std::max(0, j - 2); i <= j; i++)
+        {   // (X Y)_ij = sum over k within one of both i and j
+            double a = 0;
+            double m = 0;
+            for (int k = std::max(0, j - 1); k <= std::min(n - 1, i + 1); k++)
+            {
+                a += t(i, k)*b(k, j)/h2 + b(i, k)*potential(k)*b(k, j);
+                m += b(i, k)*b(k, j);
+            }
+            A(2 + i - j, j) = a;
+            M(2 + i - j, j) = m;
+        }
+    }
+}
+
+
+static arma::mat banded_inverse_iteration(int n, int bandwidth, const arma::mat& A,
+    const arma::mat* M, const arma::vec& eigenvalues, int iterations = 3)
+{
+    /*
+    Eigenvectors of A w = lambda M w, or A w = lambda w if M is nullptr, for
+    known eigenvalues, as inverse_iteration in tridiagonal_eig.cpp does for
+    tridiagonal matrices. A - lambda M is factorized with LAPACK dgbtrf in
+    O(n b^2), and every solve with dgbtrs is O(n b). Vectors of eigenvalues
+    closer than 1e-3 |lambda| are M-orthogonalized. The vectors are
+    normalized such that w^T M w = 1.
+    */
+
+    int k  = eigenvalues.n_elem;
+    int b  = bandwidth;
+    int kl = b;
+    int ku = b;
+    int ldab = 2*kl + ku + 1;
+    int nrhs = 1;
+    char trans = 'N';
+    int info;
+
+    auto band_value = [&](const arma::mat& X, int i, int j)
+    {   // element (i, j) of a symmetric matrix in upper band storage
+        if (i > j) std::swap(i, j);
+        return (j - i <= b) ? X(b + i - j, j) : 0.0;
+    };
+
+    auto apply_M = [&](const std::vector<double>& x, std::vector<double>& y)
+    {
+        for (int i = 0; i < n; i++)
+        {
+            if (M == nullptr)
+            {
+                y[i] = x[i];
+                continue;
+            }
+            y[i] = 0;
+            for (int j = std::max(0, i - b); j <= std::min(n - 1, i + b); j++)
+            {
+                y[i] += band_value(*M, i, j)*x[j];
+            }
+        }
+    };
+
+    arma::mat W(n, k);
+    std::vector<double> ab(ldab*n);
+    std::vector<int> ipiv(n);
+    std::vector<double> x(n);
+    std::vector<double> y(n);
+    std::vector<double> mw(n);
+
+    for (int j = 0; j < k; j++)
+    {
+        double shift = eigenvalues(j);
+
+        for (int attempt = 0; attempt < 10; attempt++)
+        {   // A - shift*M in general band storage, moving an exact shift
+            std::fill(ab.begin(), ab.end(), 0.0);
+            for (int col = 0; col < n; col++)
+            {
+                for (int row = std::max(0, col - ku); row <= std::min(n - 1, col + kl); row++)
+                {
+                    double m = (M == nullptr) ? ((row == col) ? 1.0 : 0.0) : band_value(*M, row, col);
+                    ab[kl + ku + row - col + col*ldab] = band_value(A, row, col) - shift*m;
+                }
+            }
+
+            dgbtrf_(&n, &n, &kl, &ku, ab.data(), &ldab, ipiv.data(), &info);
+            if (info == 0) break;
+            shift += 1e-14*std::max(1.0, std::fabs(shift))*(1 << attempt);
+        }
+
+        if (info != 0)
+        {
+            throw std::runtime_error("dgbtrf failed with info = " + std::to_string(info));
+        }
+
+        unsigned int seed = 12345 + j;
+        for (int i = 0; i < n; i++)
+        {   // pseudo-random start vector, not orthogonal to any eigenvector
+            seed = 1103515245u*seed + 12345u;
+            x[i] = 0.5 + (seed >> 16)/65536.0;
+        }
+
+        for (int it = 0; it < iterations; it++)
+        {
+            apply_M(x, y);
+            dgbtrs_(&trans, &n, &kl, &ku, &nrhs, ab.data(), &ldab, ipiv.data(),
+                y.data(), &n, &info, 1);
+            x = y;
+
+            for (int p = 0; p < j; p++)
+            {   // M-orthogonalizing against vectors of close eigenvalues
+                if (std::fabs(eigenvalues(p) - eigenvalues(j)) < 1e-3*std::fabs(eigenvalues(j)))
+                {
+                    std::vector<double> w_p(W.colptr(p), W.colptr(p) + n);
+                    apply_M(w_p, mw);
+                    double proj = 0;
+                    for (int i = 0; i < n; i++) proj += mw[i]*x[i];
+                    for (int i = 0; i < n; i++) x[i] -= proj*w_p[i];
+                }
+            }
+
+            apply_M(x, mw);
+            double norm = 0;
+            for (int i = 0; i < n; i++) norm += x[i]*mw[i];
+            norm = std::sqrt(norm);
+            for (int i = 0; i < n; i++) x[i] /= norm;
+        }
+
+        for (int i = 0; i < n; i++)
+        {
+            W(i, j) = x[i];
+        }
+    }
+
+    return W;
+}
+
+
+arma::vec banded_eig(int n, int bandwidth, const arma::mat& band, int num_eig,
+    arma::mat* eigenvectors)
+{
+    /*
+    The lowest eigenpairs of a symmetric band matrix. The eigenvalues are
+    found with LAPACK dsbevx, which reduces the matrix to tridiagonal form in
+    O(n^2 b) and finds the selected eigenvalues by bisection. dsbevx would
+    also form the n x n transformation of the reduction for the
+    eigenvectors, which is O(n^3), so they are found by inverse iteration on
+    the band matrix instead, O(n b^2) each.
+
+    Parameters
+    ----------
+    n : int
+        Dimension of matrix.
+
+    bandwidth : int
+        Number of super-diagonals b.
+
+    band : const arma::mat&
+        The upper triangle in band storage, see stencil_hamiltonian.
+
+    num_eig : int
+        Number of eigenpairs, the lowest num_eig are found.
+
+    eigenvectors : arma::mat*
+        If not nullptr, the normalized eigenvectors are stored here as the
+        columns of an n x num_eig matrix.
+
+    Returns
+    -------
+    eigenvalues : arma::vec
+        The num_eig lowest eigenvalues in ascending order.
+    */
+
+    char jobz  = 'N';
+    char range = 'I';
+    char uplo  = 'U';
+    int kd     = bandwidth;
+    int ldab   = bandwidth + 1;
+    int ldq    = 1;
+    int ldz    = 1;
+    int il     = 1;
+    int iu     = num_eig;
+    double vl  = 0;
+    double vu  = 0;
+    double abstol = 0;  // let LAPACK choose
+    int m;
+    int info;
+
+    std::vector<double> ab(band.memptr(), band.memptr() + ldab*n);
+    std::vector<double> q(1);
+    std::vector<double> w(n);
+    std::vector<double> work(7*n);
+    std::vector<int> iwork(5*n);
+    std::vector<int> ifail(n);
+
+    arma::mat Z(1, 1);
+
+    dsbevx_(&jobz, &range, &uplo, &n, &kd, ab.data(), &ldab, q.data(), &ldq,
+        &vl, &vu, &il, &iu, &abstol, &m, w.data(), Z.memptr(), &ldz, work.data(),
+        iwork.data(), ifail.data(), &info, 1, 1, 1);
+
+    if (info != 0)
+    {
+        throw std::runtime_error("dsbevx failed with info = " + std::to_string(info));
+    }
+
+    arma::vec eigenvalues(num_eig);
+    for (int j = 0; j < num_eig; j++)
+    {
+        eigenvalues(j) = w[j];
+    }
+
+    if (eigenvectors != nullptr)
+    {
+        *eigenvectors = banded_inverse_iteration(n, bandwidth, band, nullptr, eigenvalues);
+    }
+
+    return eigenvalues;
+}
+
+
+arma::vec banded_eig(const HamiltonianOperator& H, int num_eig, arma::mat* eigenvectors)
+{
+    /*
+    banded_eig of the band storage of a HamiltonianOperator of any
+    bandwidth, O(n b) memory.
+    */
+    return banded_eig(H.size(), H.bandwidth(), H.band(), num_eig, eigenvectors);
+}
+
+
+arma::vec banded_generalized_eig(int n, int bandwidth, const arma::mat& A,
+    const arma::mat& M, int num_eig, arma::mat* eigenvectors)
+{
+    /*
+    The lowest eigenpairs of A w = lambda M w, with A and M symmetric band
+    matrices and M positive definite, with LAPACK dsbgvx. Parameters as for
+    banded_eig, with A and M in the same band storage, and the eigenvectors
+    normalized such that w^T M w = 1. As in banded_eig, dsbgvx only finds
+    the eigenvalues, and the eigenvectors are found by inverse iteration.
+    */
+
+    char jobz  = 'N';
+    char range = 'I';
+    char uplo  = 'U';
+    int ka     = bandwidth;
+    int kb     = bandwidth;
+    int ldab   = bandwidth + 1;
+    int ldq    = 1;
+    int ldz    = 1;
+    int il     = 1;
+    int iu     = num_eig;
+    double vl  = 0;
+    double vu  = 0;
+    double abstol = 0;  // let LAPACK choose
+    int m;
+    int info;
+
+    std::vector<double> ab(A.memptr(), A.memptr() + ldab*n);
+    std::vector<double> bb(M.memptr(), M.memptr() + ldab*n);
+    std::vector<double> q(1);
+    std::vector<double> w(n);
+    std::vector<double> work(7*n);
+    std::vector<int> iwork(5*n);
+    std::vector<int> ifail(n);
+
+    arma::mat Z(1, 1);
+
+    dsbgvx_(&jobz, &range, &uplo, &n, &ka, &kb, ab.data(), &ldab, bb.data(), &ldab,
+        q.data(), &ldq, &vl, &vu, &il, &iu, &abstol, &m, w.data(), Z.memptr(), &ldz,
+        work.data(), iwork.data(), ifail.data(), &info, 1, 1, 1);
+
+    if (info != 0)
+    {
+        throw std::runtime_error("dsbgvx failed with info = " + std::to_string(info));
+    }
+
+    arma::vec eigenvalues(num_eig);
+    for (int j = 0; j < num_eig; j++)
+    {
+        eigenvalues(j) = w[j];
+    }
+
+    if (eigenvectors != nullptr)
+    {
+        *eigenvectors = banded_inverse_iteration(n, bandwidth, A, &M, eigenvalues);
+    }
+
+    return eigenvalues;
+}
+
+
+arma::vec radial_eigenvalues(std::string method, int n, double rho_max,
+    std::function<double(double)> potential, int num_eig, arma::mat* eigenvectors)
+{
+    /*
+    The lowest eigenpairs of -u'' + V(rho) u = E u with u(0) = u(rho_max) = 0
+    on n inner grid points, rho_i = (i + 1)*step, step = rho_max/(n + 1).
+
+    Parameters
+    ----------
+    method : std::string
+        "3-point", "5-point" or "7-point" for the central differences of
+        order 2, 4 and 6, see stencil_hamiltonian, or "numerov" for Numerov's
+        method of order 4, see numerov_hamiltonian. The 3-point Hamiltonian
+        is tridiagonal and solved by the "auto" EigenSolver, the others by
+        banded_eig and banded_generalized_eig.
+
+    n : int
+        Number of grid points.
+
+    rho_max : double
+        Where the potential ends.
+
+    potential : std::function<double(double)>
+        V(rho).
+
+    num_eig : int
+        Number of eigenpairs, the lowest num_eig are found.
+
+    eigenvectors : arma::mat*
+        If not nullptr, the normalized eigenvectors u are stored here as the
+        columns of an n x num_eig matrix, with the largest component positive.
+
+    Returns
+    -------
+    eigenvalues : arma::vec
+        The num_eig lowest eigenvalues in ascending order.
+    */
+
+    double step = rho_max/(n + 1);
+    arma::vec V(n);
+    for (int i = 0; i < n; i++)
+    {
+        V(i) = potential((i + 1)*step);
+    }
+
+    arma::vec eigenvalues;
+
+    if (method == "3-point")
+    {
+        arma::mat band = stencil_hamiltonian(n, step, V, 2);
+        arma::vec diag(n);
+        arma::vec off_diag(n - 1);
+        for (int i = 0; i < n; i++)
+        {
+            diag(i) = band(1, i);
+            if (i > 0) off_diag(i - 1) = band(0, i);
+        }
+        eigenvalues = make_eigen_solver("auto")->solve(n, diag, off_diag,
+            num_eig, eigenvectors);
+    }
+    else if ((method == "5-point") || (method == "7-point"))
+    {
+        int order = (method == "5-point") ? 4 : 6;
+        arma::mat band = stencil_hamiltonian(n, step, V, order);
+        eigenvalues = banded_eig(n, stencil_bandwidth(order), band, num_eig,
+            eigenvectors);
+    }
+    else if (method == "numerov")
+    {
+        arma::mat A;
+        arma::mat M;
+        numerov_hamiltonian(n, step, V, A, M);
+        eigenvalues = banded_generalized_eig(n, 2, A, M, num_eig, eigenvectors);
+
+        if (eigenvectors != nullptr)
+        {   // u = B w
+            arma::mat W = *eigenvectors;
+            for (int j = 0; j < num_eig; j++)
+            {
+                for (int i = 0; i < n; i++)
+                {
+                    double u = 10.0/12*W(i, j);
+                    if (i > 0)     u += W(i - 1, j)/12;
+                    if (i < n - 1) u += W(i + 1, j)/12;
+                    (*eigenvectors)(i, j) = u;
+                }
+            }
+        }
+    }
+    else
+    {
+        throw std::invalid_argument("unknown method: " + method);
+    }
+
+    if (eigenvectors != nullptr)
+    {
+        for (int j = 0; j < num_eig; j++)
+        {   // the largest component positive
+            int largest = 0;
+            for (int i = 1; i < n; i++)
+            {
+                if (std::fabs((*eigenvectors)(i, j)) > std::fabs((*eigenvectors)(largest, j))) largest = i;
+            }
+            if ((*eigenvectors)(largest, j) < 0)
+            {
+                for (int i = 0; i < n; i++) (*eigenvectors)(i, j) *= -1;
+            }
+        }
+    }
+
+    return eigenvalues;
+}
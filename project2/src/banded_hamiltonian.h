@@ -0,0 +1,27 @@
+#ifndef BANDED_HAMILTONIAN_H
+#define BANDED_HAMILTONIAN_H
+
+#include <armadillo>
+#include <cmath>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "eigen_solver.h"
+
+
+int stencil_bandwidth(int order);
+arma::mat stencil_hamiltonian(int n, double step, const arma::vec& potential, int order);
+void numerov_hamiltonian(int n, double step, const arma::vec& potential,
+    arma::mat& A, arma::mat& M);
+arma::vec banded_eig(int n, int bandwidth, const arma::mat& band, int num_eig,
+    arma::mat* eigenvectors = nullptr);
+arma::vec banded_eig(const HamiltonianOperator& H, int num_eig,
+    arma::mat* eigenvectors = nullptr);
+arma::vec banded_generalized_eig(int n, int bandwidth, const arma::mat& A,
+    const arma::mat& M, int num_eig, arma::mat* eigenvectors = nullptr);
+arma::vec radial_eigenvalues(std::string method, int n, double rho_max,
+    std::function<double(double)> potential, int num_eig,
+    arma::mat* eigenvectors = nullptr);
+
+#endif
@@ -0,0 +1,457 @@
+#include "jacobi.h"
+#include "eigen_solver.h"
+#include "banded_hamiltonian.h"
+#include "../../common/benchmark.h"
+#include <chrono>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+
+arma::mat harmonic_oscillator_matrix(int n)
+{
+    /*
+    Tridiagonal matrix of the single electron harmonic oscillator on
+    rho in (0, 5], as in quantum_dots.cpp.
+
+    Parameters
+    ----------
+    n : int
+        Dimension of matrix.
+    */
+
+    double step     = 5.0/(n + 1);
+    double off_diag = -1/(step*step);
+    arma::vec diag(n);
+
+    for (int i = 0; i < n; i++)
+    {   // creating the diagonal elements
+        double rho = (i + 1)*step;
+        diag(i) = 2/(step*step) + rho*rho;
+    }
+
+    return construct_diag_matrix(n, off_diag, diag);
+}
+
+
+template <class Solver>
+double time_find_eig(int n, const arma::mat& A_original, double tol_off_diag,
+    Solver solver)
+{
+    /*
+    Times one call to a Jacobi eigensolver, excluding the copy of the matrix.
+
+    Returns
+    -------
+    time : double
+        Seconds spent in solver.
+    */
+
+    arma::mat A = A_original;
+
+    std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
+    arma::mat R = solver(n, A, tol_off_diag);
+    std::chrono::steady_clock::time_point t2 = std::chrono::steady_clock::now();
+    std::chrono::duration<double> total_time = std::chrono::duration_cast<std::chrono::duration<double> >(t2 - t1);
+
+    return total_time.count();
+}
+
+
+void compare_find_max()
+{
+    /*
+    Compares the runtime of find_eig, which keeps track of the largest
+    off-diagonal element with OffDiagonalMax, with find_eig_brute_force, which
+    searches the whole matrix with find_max after every rotation. Both do the
+    same rotations. The brute force search makes a run at n = 400 take tens of
+    seconds, so only a few repetitions are done. The results are written to
+    benchmark_jacobi.csv and benchmark_jacobi.json. If the files already
+    exist, they are overwritten.
+    */
+
+    const int grid_values = 4;      // number of different grid values
+    int N[grid_values] = {50, 100, 200, 400};
+    double tol_off_diag = std::pow(10, -10);
+
+    Benchmark bench;
+    bench.set_repetitions(1, 3, 20);    // warm-up, minimum and maximum runs
+    bench.set_stop_criteria(0.02, 60);  // 2 % confidence interval, 60 s limit
+
+    for (int i = 0; i < grid_values; i++)
+    {   // looping over each grid size
+        int n = N[i];
+        arma::mat A = harmonic_oscillator_matrix(n);
+
+        bench.run("find_eig", n, 0, 0, [&]()
+            { return time_find_eig(n, A, tol_off_diag, find_eig); });
+        bench.run("find_eig_brute_force", n, 0, 0, [&]()
+            { return time_find_eig(n, A, tol_off_diag, find_eig_brute_force); });
+    }
+
+    bench.write_csv("benchmark_jacobi.csv");
+    bench.write_json("benchmark_jacobi.json");
+}
+
+
+void compare_cyclic()
+{
+    /*
+    Compares the runtime of find_eig with the cyclic Jacobi method
+    find_eig_cyclic on 1, 2, 4, ... threads, up to the number OpenMP would
+    use. Both use the tolerance 1e-10, on the largest element and on the
+    Frobenius norm of the off-diagonal elements respectively. The results are
+    written to benchmark_jacobi_cyclic.csv and benchmark_jacobi_cyclic.json.
+    If the files already exist, they are overwritten.
+    */
+
+    const int grid_values = 4;      // number of different grid values
+    int N[grid_values] = {100, 200, 400, 800};
+    double tol_off_diag = std::pow(10, -10);
+
+    int max_threads = 1;
+    #ifdef _OPENMP
+        max_threads = omp_get_max_threads();
+    #endif
+
+    Benchmark bench;
+    bench.set_repetitions(1, 3, 20);    // warm-up, minimum and maximum runs
+    bench.set_stop_criteria(0.02, 30);  // 2 % confidence interval, 30 s limit
+
+    for (int i = 0; i < grid_values; i++)
+    {   // looping over each grid size
+        int n = N[i];
+        arma::mat A = harmonic_oscillator_matrix(n);
+
+        bench.run("find_eig", n, 0, 0, [&]()
+            { return time_find_eig(n, A, tol_off_diag, find_eig); });
+
+        for (int threads = 1; threads <= max_threads; threads *= 2)
+        {   // looping over the number of threads
+            #ifdef _OPENMP
+                omp_set_num_threads(threads);
+            #endif
+
+            bench.run("find_eig_cyclic " + std::to_string(threads) + " threads", n, 0, 0,
+                [&]() { return time_find_eig(n, A, tol_off_diag,
+                    [](int n, arma::mat& A, double tol)
+                    { return find_eig_cyclic(n, A, tol); }); });
+        }
+
+        #ifdef _OPENMP
+            omp_set_num_threads(max_threads);
+        #endif
+    }
+
+    bench.write_csv("benchmark_jacobi_cyclic.csv");
+    bench.write_json("benchmark_jacobi_cyclic.json");
+}
+
+
+void compare_transform()
+{
+    /*
+    Microbenchmark of a single Jacobi rotation, transform against
+    transform_lower, on a dense symmetric matrix. Every timing is of
+    'rotations' rotations in pseudo-random planes, and the time per rotation
+    is reported, so the number of rotations per second is 1/median. A
+    rotation does 12n flops, and transform moves two rows and columns of A and
+    two columns of R, 10n doubles, which is also used for transform_lower.
+    transform is timed first, since transform_lower leaves the upper triangle
+    out of date. The results are written to benchmark_transform.csv and
+    benchmark_transform.json. If the files already exist, they are
+    overwritten.
+    */
+
+    const int grid_values = 6;      // number of different grid values
+    int N[grid_values] = {50, 100, 200, 400, 800, 1600};
+    const int rotations = 10000;
+
+    Benchmark bench;
+    bench.set_repetitions(2, 10, 200);  // warm-up, minimum and maximum runs
+    bench.set_stop_criteria(0.01, 10);  // 1 % confidence interval, 10 s limit
+
+    for (int i = 0; i < grid_values; i++)
+    {   // looping over each grid size
+        int n = N[i];
+        
+        arma::mat A(n, n);
+        arma::mat R(n, n);
+        R.zeros();
+        R.diag(0) += 1;
+
+        for (int row = 0; row < n; row++)
+        {   // populating a symmetric matrix with arbitrary values
+            for (int col = 0; col <= row; col++)
+            {
+                A(row, col) = A(col, row) = std::sin(1.0 + row + 0.5*col);
+            }
+        }
+
+        std::vector<int> planes(2*rotations);
+        unsigned int seed = 2020;
+        for (int r = 0; r < rotations; r++)
+        {   // pseudo-random pairs k != l
+            seed = 1103515245u*seed + 12345u;
+            int k = (seed >> 8) % n;
+            seed = 1103515245u*seed + 12345u;
+            int l = (k + 1 + (seed >> 8) % (n - 1)) % n;
+            planes[2*r]     = k;
+            planes[2*r + 1] = l;
+        }
+
+        auto time_rotations = [&](bool lower)
+        {
+            std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
+            for (int r = 0; r < rotations; r++)
+            {
+                if (lower)
+                {
+                    transform_lower(n, A, R, planes[2*r], planes[2*r + 1]);
+                }
+                else
+                {
+                    transform(n, A, R, planes[2*r], planes[2*r + 1]);
+                }
+            }
+            std::chrono::steady_clock::time_point t2 = std::chrono::steady_clock::now();
+            std::chrono::duration<double> total_time = std::chrono::duration_cast<std::chrono::duration<double> >(t2 - t1);
+            return total_time.count()/rotations;
+        };
+
+        bench.run("transform", n, 12.0*n, 80.0*n,
+            [&]() { return time_rotations(false); });
+        bench.run("transform_lower", n, 12.0*n, 80.0*n,
+            [&]() { return time_rotations(true); });
+    }
+
+    bench.write_csv("benchmark_transform.csv");
+    bench.write_json("benchmark_transform.json");
+}
+
+
+void compare_eigen_solvers()
+{
+    /*
+    Compares the runtime of the EigenSolver backends for the lowest num_eig
+    eigenpairs of the harmonic oscillator matrix, with eigenvectors, which
+    is what fastest_eigen_solver is based on. Only the diagonals are stored,
+    O(n) memory. Jacobi is only run up to n = 400, and QL, which is O(n^2),
+    up to n = 6400. The results are written to benchmark_eigen_solvers.csv
+    and benchmark_eigen_solvers.json. If the files already exist, they are
+    overwritten.
+    */
+
+    const int grid_values = 10;     // number of different grid values
+    int N[grid_values] = {50, 100, 200, 400, 800, 1600, 3200, 6400, 10000, 100000};
+    const int eig_values = 3;       // number of different numbers of eigenpairs
+    int num_eigs[eig_values] = {1, 8, 32};
+
+    Benchmark bench;
+    bench.set_repetitions(1, 5, 100);   // warm-up, minimum and maximum runs
+    bench.set_stop_criteria(0.02, 5);   // 2 % confidence interval, 5 s limit
+
+    for (int i = 0; i < grid_values; i++)
+    {   // looping over each grid size
+        int n = N[i];
+        double step = 5.0/(n + 1);
+        arma::vec diag(n);
+        arma::vec off_diag(n - 1);
+        off_diag.fill(-1/(step*step));
+
+        for (int j = 0; j < n; j++)
+        {   // as harmonic_oscillator_matrix, without the n x n matrix
+            double rho = (j + 1)*step;
+            diag(j) = 2/(step*step) + rho*rho;
+        }
+
+        for (int j = 0; j < eig_values; j++)
+        {   // looping over the number of eigenpairs
+            int num_eig = num_eigs[j];
+
+            for (std::string name : {"jacobi", "ql", "lapack", "lanczos"})
+            {
+                if ((name == "jacobi") && (n > 400)) continue;
+                if ((name == "ql") && (n > 6400)) continue;
+
+                std::unique_ptr<EigenSolver> solver = make_eigen_solver(name);
+                arma::mat R;
+
+                bench.run(name + " " + std::to_string(num_eig) + " eigenpairs", n, 0, 0,
+                    [&]() { solver->solve(n, diag, off_diag, num_eig, &R); });
+            }
+        }
+    }
+
+    bench.write_csv("benchmark_eigen_solvers.csv");
+    bench.write_json("benchmark_eigen_solvers.json");
+}
+
+
+void compare_continuation()
+{
+    /*
+    Compares the runtime per rho_max of a rho_max scan of the two electron
+    ground state, as in quantum_dots_two_electrons.cpp with freq = 0.25, with
+    and without the warm start of GroundStateContinuation. Every timing is of
+    a whole scan of 'scan_points' rho_max values, and the time per rho_max is
+    reported. The results are written to benchmark_continuation.csv and
+    benchmark_continuation.json. If the files already exist, they are
+    overwritten.
+    */
+
+    const int grid_values = 4;      // number of different grid values
+    int N[grid_values] = {200, 1000, 10000, 100000};
+    const int scan_points = 20;
+    double rho_min = 1e-7;
+    double freq    = 0.25;
+
+    Benchmark bench;
+    bench.set_repetitions(1, 3, 50);    // warm-up, minimum and maximum runs
+    bench.set_stop_criteria(0.02, 10);  // 2 % confidence interval, 10 s limit
+
+    for (int i = 0; i < grid_values; i++)
+    {   // looping over each grid size
+        int grid = N[i];
+        std::vector<arma::vec> diags(scan_points);
+        std::vector<double> steps(scan_points);
+        arma::vec off_diag(grid - 1);
+
+        for (int p = 0; p < scan_points; p++)
+        {   // rho_max from 7.7 in steps of 0.1
+            double rho_max = 7.7 + 0.1*p;
+            steps[p] = (rho_max - rho_min)/grid;
+            diags[p].set_size(grid);
+            for (int j = 0; j < grid; j++)
+            {
+                double rho = rho_min + j*steps[p];
+                diags[p](j) = 2/(steps[p]*steps[p]) + freq*freq*rho*rho + 1/rho;
+            }
+        }
+
+        for (bool warm_start : {false, true})
+        {
+            GroundStateContinuation continuation;
+            continuation.set_warm_start(warm_start);
+
+            bench.run(warm_start ? "warm start" : "cold start", grid, 0, 0, [&]()
+            {
+                continuation.reset();
+                arma::vec ground_state;
+
+                std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
+                for (int p = 0; p < scan_points; p++)
+                {
+                    off_diag.fill(-1/(steps[p]*steps[p]));
+                    continuation.solve(grid, diags[p], off_diag, rho_min, steps[p],
+                        ground_state);
+                }
+                std::chrono::steady_clock::time_point t2 = std::chrono::steady_clock::now();
+                std::chrono::duration<double> total_time = std::chrono::duration_cast<std::chrono::duration<double> >(t2 - t1);
+                return total_time.count()/scan_points;
+            });
+        }
+    }
+
+    bench.write_csv("benchmark_continuation.csv");
+    bench.write_json("benchmark_continuation.json");
+}
+
+
+void compare_stencils()
+{
+    /*
+    Accuracy against runtime of the finite differences of the single
+    electron harmonic oscillator, for the lowest 'num_eig' eigenpairs with
+    eigenvectors and rho_max = 8, where the exact eigenvalues are 3, 7, 11,
+    ... to about 1e-12. "3-point driver" is the existing path of
+    quantum_dots.cpp, with the grid starting at rho_min and the EigenSolver
+    "auto". The others are radial_eigenvalues, with the boundary at rho = 0 on
+    the grid. The largest relative error of the eigenvalues and the median
+    runtime of every method and grid are written to benchmark_stencils.csv,
+    and the timings to benchmark_stencils_timing.csv and
+    benchmark_stencils_timing.json. If the files already exist, they are
+    overwritten.
+    */
+
+    const int grid_values = 7;      // number of different grid values
+    int N[grid_values] = {25, 50, 100, 200, 400, 800, 1600};
+    const int num_eig = 4;
+    double rho_min = 1e-7;
+    double rho_max = 8;
+
+    Benchmark bench;
+    bench.set_repetitions(1, 5, 100);   // warm-up, minimum and maximum runs
+    bench.set_stop_criteria(0.02, 5);   // 2 % confidence interval, 5 s limit
+
+    std::ofstream error_file;
+    error_file.open("benchmark_stencils.csv");
+    error_file << "method,n,median,error\n";
+
+    for (std::string method : {"3-point driver", "3-point", "5-point", "7-point", "numerov"})
+    {
+        for (int i = 0; i < grid_values; i++)
+        {   // looping over each grid size
+            int n = N[i];
+            arma::vec eigenvalues;
+            arma::mat R;
+            BenchmarkResult result;
+
+            if (method == "3-point driver")
+            {   // as loop_rho in quantum_dots.cpp
+                double step = (rho_max - rho_min)/n;
+                arma::vec diag(n);
+                arma::vec off_diag(n - 1);
+                off_diag.fill(-1/(step*step));
+                for (int j = 0; j < n; j++)
+                {
+                    double rho = rho_min + j*step;
+                    diag(j) = 2/(step*step) + rho*rho;
+                }
+
+                std::unique_ptr<EigenSolver> solver = make_eigen_solver("auto");
+                result = bench.run(method, n, 0, 0,
+                    [&]() { eigenvalues = solver->solve(n, diag, off_diag, num_eig, &R); });
+            }
+            else
+            {
+                result = bench.run(method, n, 0, 0, [&]()
+                {
+                    eigenvalues = radial_eigenvalues(method, n, rho_max,
+                        [](double rho) { return rho*rho; }, num_eig, &R);
+                });
+            }
+
+            double error = 0;
+            for (int k = 0; k < num_eig; k++)
+            {
+                double exact = 3 + 4*k;
+                error = std::max(error, std::fabs(eigenvalues(k) - exact)/exact);
+            }
+
+            error_file << method << "," << n << "," << result.median << ",";
+            error_file << error << "\n";
+        }
+    }
+
+    error_file.close();
+    bench.write_csv("benchmark_stencils_timing.csv");
+    bench.write_json("benchmark_stencils_timing.json");
+}
+
+
+int main()
+{
+    compare_stencils();
+    compare_continuation();
+    compare_eigen_solvers();
+    compare_transform();
+    compare_find_max();
+    compare_cyclic();
+
+    return 0;
+}
@@ -0,0 +1,684 @@
+#include "eigen_solver.h"
+
+extern "C" void dstevr_(char* jobz, char* range, int* n, double* d, double* e,
+    double* vl, double* vu, int* il, int* iu, double* abstol, int* m, double* w,
+    double* z, int* ldz, int* isuppz, double* work, int* lwork, int* iwork,
+    int* liwork, int* info, size_t jobz_len, size_t range_len);
+
+
+arma::vec EigenSolver::solve(const HamiltonianOperator& H, int num_eig,
+    arma::mat* eigenvectors)
+{
+    /*
+    The lowest eigenpairs of a tridiagonal operator, from its diagonal and
+    off-diagonal only. Wider operators are solved by banded_eig in
+    banded_hamiltonian.h.
+    */
+
+    if (H.bandwidth() != 1)
+    {
+        throw std::invalid_argument("EigenSolver: the operator has bandwidth "
+            + std::to_string(H.bandwidth()) + ", use banded_eig");
+    }
+
+    return solve(H.size(), H.diagonal(), H.off_diagonal(1), num_eig, eigenvectors);
+}
+
+
+JacobiEigenSolver::JacobiEigenSolver(double tol_off_diag_input)
+{
+    /*
+    Parameters
+    ----------
+    tol_off_diag_input : double
+        Tolerance for the largest off-diagonal element, as for find_eig.
+    */
+    tol_off_diag = tol_off_diag_input;
+}
+
+
+std::string JacobiEigenSolver::name() const
+{
+    return "jacobi";
+}
+
+
+arma::vec JacobiEigenSolver::solve(int n, const arma::vec& diag,
+    const arma::vec& off_diag, int num_eig, arma::mat* eigenvectors)
+{
+    /*
+    Builds the dense matrix and uses find_eig. The eigenvalues are on the
+    diagonal afterwards, in no particular order.
+    */
+
+    arma::mat A(n, n);
+    A.zeros();
+
+    for (int i = 0; i < n; i++)
+    {
+        A(i, i) = diag(i);
+        if (i < n - 1)
+        {
+            A(i, i + 1) = A(i + 1, i) = off_diag(i);
+        }
+    }
+
+    arma::mat R = find_eig(n, A, tol_off_diag);
+    arma::uvec order = arma::sort_index(A.diag(0));
+    arma::vec eigenvalues(num_eig);
+
+    if (eigenvectors != nullptr)
+    {
+        eigenvectors->set_size(n, num_eig);
+    }
+
+    for (int j = 0; j < num_eig; j++)
+    {   // sorting eigenpairs by eigenvalue
+        eigenvalues(j) = A(order(j), order(j));
+
+        if (eigenvectors != nullptr)
+        {
+            for (int i = 0; i < n; i++)
+            {
+                (*eigenvectors)(i, j) = R(i, order(j));
+            }
+        }
+    }
+
+    return eigenvalues;
+}
+
+
+std::string QLEigenSolver::name() const
+{
+    return "ql";
+}
+
+
+arma::vec QLEigenSolver::solve(int n, const arma::vec& diag,
+    const arma::vec& off_diag, int num_eig, arma::mat* eigenvectors)
+{
+    /*
+    All eigenvalues by implicit QL, and the eigenvectors of the lowest num_eig
+    by inverse iteration. Throws std::runtime_error if QL does not converge.
+    */
+
+    arma::vec all_eigenvalues = tridiagonal_eigenvalues(n, diag, off_diag);
+    arma::vec eigenvalues(num_eig);
+
+    for (int j = 0; j < num_eig; j++)
+    {
+        eigenvalues(j) = all_eigenvalues(j);
+    }
+
+    if (eigenvectors != nullptr)
+    {
+        *eigenvectors = inverse_iteration(n, diag, off_diag, eigenvalues);
+    }
+
+    return eigenvalues;
+}
+
+
+std::string LapackEigenSolver::name() const
+{
+    return "lapack";
+}
+
+
+arma::vec LapackEigenSolver::solve(int n, const arma::vec& diag,
+    const arma::vec& off_diag, int num_eig, arma::mat* eigenvectors)
+{
+    /*
+    LAPACK dstevr, which finds eigenvalues il to iu of a symmetric
+    tridiagonal matrix by bisection or dqds, and their eigenvectors by the
+    MRRR algorithm, O(n) per eigenvector. This is what dsyevr uses after it
+    has reduced a dense matrix to tridiagonal form, which our matrices
+    already are.
+    */
+
+    char jobz  = (eigenvectors != nullptr) ? 'V' : 'N';
+    char range = 'I';
+    int il     = 1;
+    int iu     = num_eig;
+    int ldz    = n;
+    double vl  = 0;
+    double vu  = 0;
+    double abstol = 0;  // let LAPACK choose
+    int m;
+    int info;
+
+    std::vector<double> d(diag.memptr(), diag.memptr() + n);
+    std::vector<double> e(n, 0);
+    std::vector<double> w(n);
+    std::vector<int> isuppz(2*num_eig);
+
+    for (int i = 0; i < n - 1; i++)
+    {
+        e[i] = off_diag(i);
+    }
+
+    arma::mat Z(1, 1);
+    if (eigenvectors != nullptr)
+    {
+        Z.set_size(n, num_eig);
+    }
+
+    int lwork  = 20*n;
+    int liwork = 10*n;
+    std::vector<double> work(lwork);
+    std::vector<int> iwork(liwork);
+
+    dstevr_(&jobz, &range, &n, d.data(), e.data(), &vl, &vu, &il, &iu, &abstol,
+        &m, w.data(), Z.memptr(), &ldz, isuppz.data(), work.data(), &lwork,
+        iwork.data(), &liwork, &info, 1, 1);
+
+    if (info != 0)
+    {
+        throw std::runtime_error("dstevr failed with info = " + std::to_string(info));
+    }
+
+    arma::vec eigenvalues(num_eig);
+    for (int j = 0; j < num_eig; j++)
+    {
+        eigenvalues(j) = w[j];
+    }
+
+    if (eigenvectors != nullptr)
+    {
+        *eigenvectors = Z;
+    }
+
+    return eigenvalues;
+}
+
+
+LanczosEigenSolver::LanczosEigenSolver(double tol_input, int max_iterations_input)
+{
+    /*
+    Parameters
+    ----------
+    tol_input : double
+        Relative residual |(T - sigma)^-1 v - theta v|/|theta| at which a
+        Ritz pair is accepted.
+
+    max_iterations_input : int
+        Largest number of Lanczos vectors.
+    */
+    tol = tol_input;
+    max_iterations = max_iterations_input;
+}
+
+
+std::string LanczosEigenSolver::name() const
+{
+    return "lanczos";
+}
+
+
+arma::vec LanczosEigenSolver::solve(int n, const arma::vec& diag,
+    const arma::vec& off_diag, int num_eig, arma::mat* eigenvectors)
+{
+    /*
+    Lanczos with full reorthogonalization on (T - sigma*I)^-1, where sigma is
+    just below the Gershgorin lower bound of the spectrum. The lowest
+    eigenvalues lambda of T are then the largest, well separated, eigenvalues
+    theta = 1/(lambda - sigma) of the operator, which Lanczos finds in a few
+    tens of iterations. T - sigma*I is positive definite, so it is factorized
+    once with the Thomas algorithm without pivoting, and every iteration
+    costs O(n) for the solve plus O(kn) for the reorthogonalization. T is
+    never formed, and the Lanczos vectors are only allocated as they are
+    needed, so the memory is O(kn) for k iterations.
+
+    If the Lanczos vectors span an invariant subspace before there are
+    num_eig of them, e.g., for degenerate eigenvalues or n close to num_eig,
+    the iteration restarts from a new random vector orthogonal to all of
+    them. The projected matrix is then block diagonal, with beta_j = 0.
+
+    If the lowest num_eig Ritz pairs do not reach the relative residual tol
+    within max_iterations Lanczos vectors, it throws instead of returning
+    them.
+
+    The distance from sigma to the spectrum is relative to the Gershgorin
+    bound, not to the norm of T, which grows as 1/h^2. Otherwise the ratio
+    theta_2/theta_1, which sets the convergence, goes to 1 on fine grids.
+    */
+
+    double lower  = diag(0);
+    double norm_T = 0;
+    for (int i = 0; i < n; i++)
+    {   // Gershgorin discs
+        double radius = 0;
+        if (i > 0)     radius += std::fabs(off_diag(i - 1));
+        if (i < n - 1) radius += std::fabs(off_diag(i));
+        lower  = std::min(lower, diag(i) - radius);
+        norm_T = std::max(norm_T, std::fabs(diag(i)) + radius);
+    }
+
+    std::vector<double> inv_pivot(n);
+    std::vector<double> upper(n);
+    double offset = 1e-3*std::max(std::fabs(lower), 1.0);
+    double tiny   = std::numeric_limits<double>::epsilon()*norm_T;
+    double sigma;
+    bool positive = false;
+
+    while (!positive)
+    {   // moving sigma further down if a pivot is not safely positive
+        sigma = lower - offset;
+        positive = true;
+        
+        for (int i = 0; i < n; i++)
+        {   // LU of T - sigma*I, the multipliers are off_diag*inv_pivot
+            double pivot = diag(i) - sigma;
+            if (i > 0) pivot -= off_diag(i - 1)*upper[i - 1];
+            if (pivot <= tiny) positive = false;
+            inv_pivot[i] = 1/pivot;
+            upper[i] = (i < n - 1) ? off_diag(i)*inv_pivot[i] : 0;
+        }
+        
+        offset *= 10;
+    }
+
+    auto apply = [&](const double* x, double* y)
+    {   // y = (T - sigma*I)^-1 x
+        y[0] = x[0]*inv_pivot[0];
+        for (int i = 1; i < n; i++)
+        {
+            y[i] = (x[i] - off_diag(i - 1)*y[i - 1])*inv_pivot[i];
+        }
+        for (int i = n - 2; i >= 0; i--)
+        {
+            y[i] -= upper[i]*y[i + 1];
+        }
+    };
+
+    int max_steps = std::min(n, max_iterations);
+    std::vector<std::vector<double> > V;   // Lanczos vectors
+    V.reserve(max_steps);
+    V.emplace_back(n);
+    std::vector<double> alpha(max_steps);
+    std::vector<double> beta(max_steps);
+    std::vector<double> w(n);
+
+    unsigned int seed = 12345;
+    auto random_vector = [&](double* x)
+    {   // pseudo-random elements in [0.5, 1.5), returns the norm
+        double sum = 0;
+        for (int i = 0; i < n; i++)
+        {
+            seed = 1103515245u*seed + 12345u;
+            x[i] = 0.5 + (seed >> 16)/65536.0;
+            sum += x[i]*x[i];
+        }
+        return std::sqrt(sum);
+    };
+
+    auto orthogonalize = [&](int last)
+    {   // w minus its projection on V[0], ..., V[last], returns w^T V[last]
+        double proj_last = 0;
+        for (int pass = 0; pass < 2; pass++)
+        {   // full reorthogonalization, twice is enough
+            for (int p = 0; p <= last; p++)
+            {
+                const double* v_p = V[p].data();
+                double proj = 0;
+                for (int i = 0; i < n; i++) proj += v_p[i]*w[i];
+                for (int i = 0; i < n; i++) w[i] -= proj*v_p[i];
+                if (p == last) proj_last += proj;
+            }
+        }
+        return proj_last;
+    };
+
+    double* v = V[0].data();
+    double norm = random_vector(v);
+    for (int i = 0; i < n; i++) v[i] /= norm;
+
+    arma::vec theta;
+    arma::mat S;
+    int steps = 0;
+    bool converged = false;
+
+    for (int j = 0; j < max_steps; j++)
+    {
+        v = V[j].data();
+        apply(v, w.data());
+        steps = j + 1;
+
+        alpha[j] = orthogonalize(j);
+
+        norm = 0;
+        for (int i = 0; i < n; i++) norm += w[i]*w[i];
+        beta[j] = std::sqrt(norm);
+
+        bool invariant = (beta[j] <= 1e-14*std::fabs(alpha[j]));
+
+        if (invariant && (steps < num_eig) && (j + 1 < max_steps))
+        {   // breakdown, restarting orthogonal to the invariant subspace
+            double norm_random = random_vector(w.data());
+            orthogonalize(j);
+
+            norm = 0;
+            for (int i = 0; i < n; i++) norm += w[i]*w[i];
+            norm = std::sqrt(norm);
+            if (norm <= 1e-8*norm_random)
+            {
+                throw std::runtime_error("lanczos: no restart vector orthogonal "
+                    "to the invariant subspace");
+            }
+
+            for (int i = 0; i < n; i++) w[i] /= norm;
+            V.emplace_back(w.begin(), w.end());
+            beta[j] = 0;
+            continue;
+        }
+        bool check = (steps >= num_eig) && ((steps % 5 == 0) || invariant ||
+            (steps == max_steps));
+
+        if (check)
+        {   // Ritz values of the projected tridiagonal matrix
+            arma::vec a(steps);
+            arma::vec b(steps);
+            for (int i = 0; i < steps; i++)
+            {
+                a(i) = alpha[i];
+                b(i) = beta[i];
+            }
+            S = tridiagonal_eig(steps, a, b, theta);
+
+            converged = true;
+            for (int k = 0; k < num_eig; k++)
+            {   // the largest theta, residual beta_j*|last component|
+                int idx = steps - 1 - k;
+                double residual = beta[j]*std::fabs(S(steps - 1, idx));
+                if (residual > tol*std::fabs(theta(idx))) converged = false;
+            }
+
+            if (invariant)
+            {   // the Ritz pairs are exact
+                converged = true;
+            }
+            if (converged) break;
+        }
+
+        if (j + 1 < max_steps)
+        {
+            V.emplace_back(n);
+            double* v_next = V[j + 1].data();
+            for (int i = 0; i < n; i++) v_next[i] = w[i]/beta[j];
+        }
+    }
+
+    if (theta.n_elem < (arma::uword)num_eig)
+    {
+        throw std::runtime_error("lanczos: fewer Lanczos vectors than eigenpairs");
+    }
+
+    if (!converged)
+    {
+        throw std::runtime_error("lanczos: not converged to tol after "
+            + std::to_string(steps) + " iterations");
+    }
+
+    arma::vec eigenvalues(num_eig);
+    if (eigenvectors != nullptr)
+    {
+        eigenvectors->set_size(n, num_eig);
+    }
+
+    for (int k = 0; k < num_eig; k++)
+    {   // lambda = sigma + 1/theta, the largest theta first
+        int idx = steps - 1 - k;
+        eigenvalues(k) = sigma + 1/theta(idx);
+
+        if (eigenvectors != nullptr)
+        {   // Ritz vector V s, normalized with the largest component positive
+            std::fill(w.begin(), w.end(), 0);
+            for (int p = 0; p < steps; p++)
+            {
+                const double* v_p = V[p].data();
+                double s_p = S(p, idx);
+                for (int i = 0; i < n; i++) w[i] += s_p*v_p[i];
+            }
+
+            norm = 0;
+            int largest = 0;
+            for (int i = 0; i < n; i++)
+            {
+                norm += w[i]*w[i];
+                if (std::fabs(w[i]) > std::fabs(w[largest])) largest = i;
+            }
+            norm = (w[largest] < 0) ? -std::sqrt(norm) : std::sqrt(norm);
+
+            for (int i = 0; i < n; i++)
+            {
+                (*eigenvectors)(i, k) = w[i]/norm;
+            }
+        }
+    }
+
+    return eigenvalues;
+}
+
+
+AutoEigenSolver::AutoEigenSolver()
+{
+    ql      = make_eigen_solver("ql");
+    lapack  = make_eigen_solver("lapack");
+    lanczos = make_eigen_solver("lanczos");
+}
+
+
+std::string AutoEigenSolver::name() const
+{
+    /*
+    "auto", followed by the backend of the last solve, e.g., "auto/ql".
+    */
+    return (last == "auto") ? last : "auto/" + last;
+}
+
+
+arma::vec AutoEigenSolver::solve(int n, const arma::vec& diag,
+    const arma::vec& off_diag, int num_eig, arma::mat* eigenvectors)
+{
+    last = fastest_eigen_solver(n, num_eig);
+
+    if (last == "lanczos")
+    {
+        return lanczos->solve(n, diag, off_diag, num_eig, eigenvectors);
+    }
+    if (last == "lapack")
+    {
+        return lapack->solve(n, diag, off_diag, num_eig, eigenvectors);
+    }
+    return ql->solve(n, diag, off_diag, num_eig, eigenvectors);
+}
+
+
+GroundStateContinuation::GroundStateContinuation(std::string name)
+{
+    /*
+    Parameters
+    ----------
+    name : std::string
+        Backend for the cold solves, see make_eigen_solver. Defaults to
+        "auto".
+    */
+    solver = make_eigen_solver(name);
+}
+
+
+void GroundStateContinuation::set_solver(std::string name)
+{
+    solver = make_eigen_solver(name);
+}
+
+
+void GroundStateContinuation::set_warm_start(bool warm_start_input)
+{
+    /*
+    With warm_start = false every solve is a cold solve, as without the
+    continuation.
+    */
+    warm_start = warm_start_input;
+}
+
+
+void GroundStateContinuation::reset()
+{
+    /*
+    Forgets the previous ground state, so the next solve is a cold solve.
+    */
+    have_previous = false;
+}
+
+
+int GroundStateContinuation::number_of_warm_solves() const
+{
+    return warm_solves;
+}
+
+
+int GroundStateContinuation::number_of_cold_solves() const
+{
+    return cold_solves;
+}
+
+
+arma::vec GroundStateContinuation::interpolate_previous(int n, double rho_first,
+    double step) const
+{
+    /*
+    The previous ground state, linearly interpolated onto the grid
+    rho_first + i*step, and zero outside the previous grid, where the
+    previous boundary condition is.
+    */
+
+    int n_previous = ground_state_previous.n_elem;
+    arma::vec x(n);
+
+    for (int i = 0; i < n; i++)
+    {
+        double position = (rho_first + i*step - rho_first_previous)/step_previous;
+        int left = (int) std::floor(position);
+
+        if ((position < -1) || (position > n_previous))
+        {
+            x(i) = 0;
+            continue;
+        }
+
+        double weight = position - left;
+        double value_left  = ((left >= 0) && (left < n_previous)) ? ground_state_previous(left) : 0;
+        double value_right = ((left + 1 >= 0) && (left + 1 < n_previous)) ? ground_state_previous(left + 1) : 0;
+        x(i) = (1 - weight)*value_left + weight*value_right;
+    }
+
+    return x;
+}
+
+
+double GroundStateContinuation::solve(int n, const arma::vec& diag,
+    const arma::vec& off_diag, double rho_first, double step, arma::vec& ground_state)
+{
+    if (warm_start && have_previous)
+    {
+        arma::vec x = interpolate_previous(n, rho_first, step);
+        double eigenvalue;
+        int iterations = rayleigh_quotient_iteration(n, diag, off_diag, x, eigenvalue);
+
+        double norm_T = 0;
+        for (int i = 0; i < n; i++)
+        {   // infinity norm of T, the Sturm count is only accurate to ~eps*|T|
+            double row = std::fabs(diag(i));
+            if (i > 0)     row += std::fabs(off_diag(i - 1));
+            if (i < n - 1) row += std::fabs(off_diag(i));
+            norm_T = std::max(norm_T, row);
+        }
+        double margin = 1e-10*norm_T;
+
+        if ((iterations >= 0) && (sturm_count(n, diag, off_diag, eigenvalue - margin) == 0))
+        {   // converged to the ground state
+            warm_solves++;
+            ground_state = x;
+            rho_first_previous    = rho_first;
+            step_previous         = step;
+            ground_state_previous = x;
+            return eigenvalue;
+        }
+    }
+
+    arma::mat eigenvectors;
+    arma::vec eigenvalues = solver->solve(n, diag, off_diag, 1, &eigenvectors);
+    cold_solves++;
+
+    ground_state = eigenvectors.col(0);
+    have_previous         = true;
+    rho_first_previous    = rho_first;
+    step_previous         = step;
+    ground_state_previous = ground_state;
+
+    return eigenvalues(0);
+}
+
+
+double GroundStateContinuation::solve(const RadialHamiltonian& H,
+    arma::vec& ground_state)
+{
+    return solve(H.size(), H.diagonal(), H.off_diagonal(1), H.rho(0),
+        H.step_size(), ground_state);
+}
+
+
+std::string fastest_eigen_solver(int n, int num_eig)
+{
+    /*
+    The fastest backend for a problem, from the timings of
+    compare_eigen_solvers in benchmark_jacobi.cpp on the harmonic oscillator
+    matrix. QL is fastest when a large part of the spectrum is wanted, dstevr
+    for small matrices, and Lanczos otherwise, e.g., 8 eigenpairs at
+    n = 1600 take 2.4 ms against 4.4 ms with dstevr and 86 ms with QL, and
+    the ground state at n = 10^5 takes 50 ms. Jacobi is never the fastest.
+    The ranking is the same, within 30 %, when only the eigenvalues are
+    needed.
+
+    Parameters
+    ----------
+    n : int
+        Dimension of matrix.
+
+    num_eig : int
+        Number of eigenpairs.
+    */
+
+    if (n <= 8*num_eig)
+    {
+        return "ql";
+    }
+    if (n < 200)
+    {
+        return "lapack";
+    }
+    return "lanczos";
+}
+
+
+std::unique_ptr<EigenSolver> make_eigen_solver(std::string name)
+{
+    /*
+    Makes the backend with the given name, see EigenSolver.
+
+    Parameters
+    ----------
+    name : std::string
+        "jacobi", "ql", "lapack", "lanczos" or "auto".
+    */
+
+    if (name == "jacobi")  return std::unique_ptr<EigenSolver>(new JacobiEigenSolver());
+    if (name == "ql")      return std::unique_ptr<EigenSolver>(new QLEigenSolver());
+    if (name == "lapack")  return std::unique_ptr<EigenSolver>(new LapackEigenSolver());
+    if (name == "lanczos") return std::unique_ptr<EigenSolver>(new LanczosEigenSolver());
+    if (name == "auto")    return std::unique_ptr<EigenSolver>(new AutoEigenSolver());
+
+    throw std::invalid_argument("unknown eigen solver: " + name);
+}
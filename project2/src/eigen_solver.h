@@ -0,0 +1,210 @@
+#ifndef EIGEN_SOLVER_H
+#define EIGEN_SOLVER_H
+
+#include <armadillo>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "hamiltonian_operator.h"
+#include "jacobi.h"
+#include "tridiagonal_eig.h"
+
+
+class EigenSolver
+{
+    /*
+    Interface for finding the lowest eigenpairs of a symmetric tridiagonal
+    matrix, which is what the quantum dot drivers need. A driver holds a
+    pointer to an EigenSolver made by make_eigen_solver, so the backend can be
+    chosen at runtime by name:
+
+        "jacobi"    find_eig on the dense matrix, O(n^3), all eigenpairs.
+        "ql"        implicit QL on the two diagonals, O(n^2), plus inverse
+                    iteration for the requested eigenvectors.
+        "lapack"    LAPACK dstevr, selected eigenpairs by index.
+        "lanczos"   shift-invert Lanczos for the few lowest eigenpairs,
+                    O(n) per iteration.
+        "auto"      the backend from fastest_eigen_solver for every call.
+
+    solve takes the following parameters.
+
+    Parameters
+    ----------
+    n : int
+        Dimension of matrix.
+
+    diag : const arma::vec&
+        Diagonal elements, n values.
+
+    off_diag : const arma::vec&
+        Off-diagonal elements, at least n-1 values.
+
+    num_eig : int
+        Number of eigenpairs, the lowest num_eig are found.
+
+    eigenvectors : arma::mat*
+        If not nullptr, the normalized eigenvectors are stored here as the
+        columns of an n x num_eig matrix.
+
+    Returns
+    -------
+    eigenvalues : arma::vec
+        The num_eig lowest eigenvalues in ascending order.
+
+    solve can also take a tridiagonal HamiltonianOperator instead of n, diag
+    and off_diag.
+    */
+public:
+    virtual ~EigenSolver() {}
+
+    virtual std::string name() const = 0;
+
+    virtual arma::vec solve(int n, const arma::vec& diag, const arma::vec& off_diag,
+        int num_eig, arma::mat* eigenvectors = nullptr) = 0;
+
+    arma::vec solve(const HamiltonianOperator& H, int num_eig,
+        arma::mat* eigenvectors = nullptr);
+};
+
+
+class JacobiEigenSolver : public EigenSolver
+{
+private:
+    double tol_off_diag;
+
+public:
+    JacobiEigenSolver(double tol_off_diag_input = 1e-10);
+    using EigenSolver::solve;
+    std::string name() const override;
+    arma::vec solve(int n, const arma::vec& diag, const arma::vec& off_diag,
+        int num_eig, arma::mat* eigenvectors = nullptr) override;
+};
+
+
+class QLEigenSolver : public EigenSolver
+{
+public:
+    using EigenSolver::solve;
+    std::string name() const override;
+    arma::vec solve(int n, const arma::vec& diag, const arma::vec& off_diag,
+        int num_eig, arma::mat* eigenvectors = nullptr) override;
+};
+
+
+class LapackEigenSolver : public EigenSolver
+{
+public:
+    using EigenSolver::solve;
+    std::string name() const override;
+    arma::vec solve(int n, const arma::vec& diag, const arma::vec& off_diag,
+        int num_eig, arma::mat* eigenvectors = nullptr) override;
+};
+
+
+class LanczosEigenSolver : public EigenSolver
+{
+private:
+    double tol;             // relative residual of the Ritz pairs
+    int max_iterations;     // largest Krylov subspace
+
+public:
+    LanczosEigenSolver(double tol_input = 1e-12, int max_iterations_input = 300);
+    using EigenSolver::solve;
+    std::string name() const override;
+    arma::vec solve(int n, const arma::vec& diag, const arma::vec& off_diag,
+        int num_eig, arma::mat* eigenvectors = nullptr) override;
+};
+
+
+class AutoEigenSolver : public EigenSolver
+{
+private:
+    std::unique_ptr<EigenSolver> ql;
+    std::unique_ptr<EigenSolver> lapack;
+    std::unique_ptr<EigenSolver> lanczos;
+    std::string last = "auto";  // backend of the last solve
+
+public:
+    AutoEigenSolver();
+    using EigenSolver::solve;
+    std::string name() const override;
+    arma::vec solve(int n, const arma::vec& diag, const arma::vec& off_diag,
+        int num_eig, arma::mat* eigenvectors = nullptr) override;
+};
+
+
+class GroundStateContinuation
+{
+    /*
+    Ground state of a sequence of slightly different Hamiltonians, e.g., the
+    rho_max and frequency scans in quantum_dots_two_electrons.cpp. The matrix
+    must be symmetric tridiagonal on a uniform grid rho_i = rho_first + i*step.
+
+    The first solve is done by an EigenSolver. Every later solve interpolates
+    the previous ground state linearly onto the new grid, zero outside the
+    previous grid, and refines it with rayleigh_quotient_iteration, two or
+    three O(n) solves. sturm_count checks that the refined pair is the ground
+    state, otherwise, or if the iteration does not converge, the EigenSolver
+    is used again.
+
+    solve takes the following parameters.
+
+    Parameters
+    ----------
+    n : int
+        Dimension of matrix.
+
+    diag : const arma::vec&
+        Diagonal elements, n values.
+
+    off_diag : const arma::vec&
+        Off-diagonal elements, n-1 values.
+
+    rho_first : double
+        Grid point of the first row.
+
+    step : double
+        Step size of the grid.
+
+    ground_state : arma::vec&
+        The normalized ground state, with the largest component positive.
+
+    Returns
+    -------
+    eigenvalue : double
+        The lowest eigenvalue.
+
+    solve can also take a RadialHamiltonian, which gives all of the above.
+    */
+private:
+    std::unique_ptr<EigenSolver> solver;    // for the cold solves
+    bool warm_start = true;
+    bool have_previous = false;
+    double rho_first_previous;
+    double step_previous;
+    arma::vec ground_state_previous;
+    int warm_solves = 0;
+    int cold_solves = 0;
+
+    arma::vec interpolate_previous(int n, double rho_first, double step) const;
+
+public:
+    GroundStateContinuation(std::string name = "auto");
+    void set_solver(std::string name);
+    void set_warm_start(bool warm_start_input);
+    void reset();
+    double solve(int n, const arma::vec& diag, const arma::vec& off_diag,
+        double rho_first, double step, arma::vec& ground_state);
+    double solve(const RadialHamiltonian& H, arma::vec& ground_state);
+    int number_of_warm_solves() const;
+    int number_of_cold_solves() const;
+};
+
+
+std::string fastest_eigen_solver(int n, int num_eig);
+std::unique_ptr<EigenSolver> make_eigen_solver(std::string name);
+
+#endif
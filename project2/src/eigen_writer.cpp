@@ -0,0 +1,215 @@
+#include "eigen_writer.h"
+
+
+EigenWriter::EigenWriter(std::string filename_input, std::size_t buffer_size_input,
+    bool background_input)
+{
+    filename    = filename_input;
+    buffer_size = buffer_size_input;
+    background  = background_input;
+
+    file.open(filename, std::ios_base::binary | std::ios_base::app);
+    if (!file)
+    {
+        throw std::runtime_error("could not open " + filename);
+    }
+
+    buffer.reserve(buffer_size);
+    pending.reserve(buffer_size);
+
+    file.seekp(0, std::ios_base::end);
+    if (file.tellp() == 0)
+    {   // new file
+        file.write("QDEIGV01", 8);
+    }
+
+    if (background)
+    {
+        writer = std::thread(&EigenWriter::writer_loop, this);
+    }
+}
+
+
+EigenWriter::~EigenWriter()
+{
+    try
+    {
+        close();
+    }
+    catch (const std::runtime_error&)
+    {   // a destructor must not throw, call close to see the error
+    }
+}
+
+
+void EigenWriter::writer_loop()
+{
+    /*
+    Writes the pending buffer whenever hand_off has filled it, until close.
+    */
+
+    std::unique_lock<std::mutex> lock(mutex);
+
+    while (true)
+    {
+        ready.wait(lock, [this]() { return pending_full || stop; });
+        if (!pending_full) break;
+
+        lock.unlock();
+        file.write(pending.data(), pending.size());
+        bool write_failed = !file;
+        lock.lock();
+
+        if (write_failed) failed = true;
+        pending.clear();
+        pending_full = false;
+        ready.notify_all();
+    }
+}
+
+
+void EigenWriter::hand_off()
+{
+    /*
+    Empties the buffer, either by writing it, or by swapping it with the
+    pending buffer of the writer thread, once that has been written.
+    */
+
+    if (buffer.empty()) return;
+
+    if (!background)
+    {
+        file.write(buffer.data(), buffer.size());
+        buffer.clear();
+        if (!file) failed = true;
+        check_failed();
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(mutex);
+    ready.wait(lock, [this]() { return !pending_full; });
+    std::swap(buffer, pending);
+    pending_full = true;
+    ready.notify_all();
+}
+
+
+void EigenWriter::write(double rho_max, double eigenvalue, const arma::vec& eigenvector)
+{
+    /*
+    Appends one record. Throws std::runtime_error if an earlier write to the
+    file has failed.
+
+    Parameters
+    ----------
+    rho_max : double
+        Where the potential ends.
+
+    eigenvalue : double
+        Ground state eigenvalue.
+
+    eigenvector : const arma::vec&
+        Ground state eigenvector, n values.
+    */
+
+    check_failed();
+
+    std::int64_t n = eigenvector.n_elem;
+    std::size_t record_size = 8*(n + 3);
+
+    if (buffer.size() + record_size > buffer_size)
+    {
+        hand_off();
+    }
+
+    std::size_t offset = buffer.size();
+    buffer.resize(offset + record_size);
+    char* record = buffer.data() + offset;
+
+    std::memcpy(record,      &n,          8);
+    std::memcpy(record + 8,  &rho_max,    8);
+    std::memcpy(record + 16, &eigenvalue, 8);
+    std::memcpy(record + 24, eigenvector.memptr(), 8*n);
+}
+
+
+void EigenWriter::flush()
+{
+    /*
+    Writes everything written so far to the file. Throws std::runtime_error
+    if a write has failed.
+    */
+
+    hand_off();
+
+    if (background)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        ready.wait(lock, [this]() { return !pending_full; });
+    }
+
+    file.flush();
+    if (!file)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        failed = true;
+    }
+    check_failed();
+}
+
+
+void EigenWriter::check_failed()
+{
+    /*
+    Throws std::runtime_error if a write to the file has failed, here or on
+    the writer thread.
+    */
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (failed)
+    {
+        throw std::runtime_error("could not write to " + filename);
+    }
+}
+
+
+void EigenWriter::stop_writer()
+{
+    /*
+    Stops the writer thread once the pending buffer has been written.
+    */
+
+    if (!writer.joinable()) return;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stop = true;
+    }
+    ready.notify_all();
+    writer.join();
+}
+
+
+void EigenWriter::close()
+{
+    /*
+    Flushes and closes the file, and stops the writer thread. Throws
+    std::runtime_error if a write has failed, after the file is closed.
+    */
+
+    if (!file.is_open()) return;
+
+    try
+    {
+        flush();
+    }
+    catch (const std::runtime_error&)
+    {
+        stop_writer();
+        file.close();
+        throw;
+    }
+
+    stop_writer();
+    file.close();
+}
@@ -0,0 +1,82 @@
+#ifndef EIGEN_WRITER_H
+#define EIGEN_WRITER_H
+
+#include <armadillo>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+class EigenWriter
+{
+    /*
+    Binary writer for the ground states of a scan, as an alternative to the
+    text files of compute_and_write_eigendata, which take 20 characters per
+    element and flush every line. The file is opened in append mode and
+    consists of, in native byte order (little-endian on x86),
+
+        8 bytes     "QDEIGV01", only at the start of a new file
+        record      int64 n, double rho_max, double eigenvalue, n doubles
+
+    so a record of a grid with n points is 8(n + 3) bytes. read_eigendata in
+    quantum_dots.py reads the files.
+
+    The records are collected in a user-space buffer, which is written to
+    the file when full. With background = true, a full buffer is handed to a
+    writer thread and a second buffer is filled in the meantime, so the
+    solves do not wait for the disk.
+
+    If a write to the file fails, e.g., on a full disk, flush and close throw
+    std::runtime_error. A failure on the writer thread is recorded and thrown
+    by the next write, flush or close. The destructor closes the file, but
+    ignores the error.
+
+    Parameters
+    ----------
+    filename : std::string
+        Name of the file, e.g., "eigendata_omega_0.250000.bin".
+
+    buffer_size : std::size_t
+        Bytes per buffer. Defaults to 8 MiB.
+
+    background : bool
+        Toggling the writer thread on/off. Defaults to false.
+    */
+private:
+    std::ofstream file;
+    std::string filename;
+    std::vector<char> buffer;           // filled by write
+    std::vector<char> pending;          // being written by the writer thread
+    std::size_t buffer_size;
+    bool background;
+    bool pending_full = false;          // pending is waiting for the thread
+    bool stop = false;
+    bool failed = false;                // a write to the file has failed
+    std::thread writer;
+    std::mutex mutex;
+    std::condition_variable ready;
+
+    void hand_off();
+    void writer_loop();
+    void check_failed();
+    void stop_writer();
+
+public:
+    EigenWriter(std::string filename_input, std::size_t buffer_size_input = 8 << 20,
+        bool background_input = false);
+    EigenWriter(const EigenWriter&) = delete;
+    EigenWriter& operator=(const EigenWriter&) = delete;
+    ~EigenWriter();
+
+    void write(double rho_max, double eigenvalue, const arma::vec& eigenvector);
+    void flush();
+    void close();
+};
+
+#endif
@@ -0,0 +1,216 @@
+#include "hamiltonian_operator.h"
+
+
+arma::mat HamiltonianOperator::band() const
+{
+    /*
+    The upper triangle in LAPACK band storage, as stencil_hamiltonian in
+    banded_hamiltonian.cpp, a (b + 1) x n matrix with band(b + i - j, j) =
+    H(i, j) for j - b <= i <= j.
+    */
+
+    int n = size();
+    int b = bandwidth();
+    arma::mat band(b + 1, n);
+    band.zeros();
+
+    arma::vec diag = diagonal();
+    for (int j = 0; j < n; j++)
+    {
+        band(b, j) = diag(j);
+    }
+
+    for (int k = 1; k <= b; k++)
+    {
+        arma::vec off_diag = off_diagonal(k);
+        for (int j = k; j < n; j++)
+        {
+            band(b - k, j) = off_diag(j - k);
+        }
+    }
+
+    return band;
+}
+
+
+arma::mat HamiltonianOperator::dense() const
+{
+    /*
+    The n x n matrix, for the Jacobi backend and for testing. O(n^2) memory.
+    */
+
+    int n = size();
+    arma::mat A(n, n);
+    A.zeros();
+
+    arma::vec diag = diagonal();
+    for (int i = 0; i < n; i++)
+    {
+        A(i, i) = diag(i);
+    }
+
+    for (int k = 1; k <= bandwidth(); k++)
+    {
+        arma::vec off_diag = off_diagonal(k);
+        for (int i = 0; i < n - k; i++)
+        {
+            A(i, i + k) = off_diag(i);
+            A(i + k, i) = off_diag(i);
+        }
+    }
+
+    return A;
+}
+
+
+double HamiltonianOperator::residual(double eigenvalue, const arma::vec& x) const
+{
+    /*
+    |H x - eigenvalue x|, with one apply.
+
+    Parameters
+    ----------
+    eigenvalue : double
+        Approximate eigenvalue.
+
+    x : const arma::vec&
+        Approximate eigenvector, n values.
+    */
+
+    arma::vec y(size());
+    apply(x, y);
+
+    double sum = 0;
+    for (int i = 0; i < size(); i++)
+    {
+        double r = y(i) - eigenvalue*x(i);
+        sum += r*r;
+    }
+
+    return std::sqrt(sum);
+}
+
+
+RadialHamiltonian::RadialHamiltonian(int n_input, double rho_min_input,
+    double rho_max_input)
+{
+    if (n_input < 2)
+    {
+        throw std::invalid_argument("RadialHamiltonian needs at least 2 grid points");
+    }
+
+    n       = n_input;
+    rho_min = rho_min_input;
+    step    = (rho_max_input - rho_min)/n;
+}
+
+
+int RadialHamiltonian::size() const
+{
+    return n;
+}
+
+
+int RadialHamiltonian::bandwidth() const
+{
+    return 1;
+}
+
+
+double RadialHamiltonian::rho(int i) const
+{
+    return rho_min + i*step;
+}
+
+
+double RadialHamiltonian::step_size() const
+{
+    return step;
+}
+
+
+void RadialHamiltonian::apply(const arma::vec& x, arma::vec& y) const
+{
+    /*
+    y = H x, without storing the diagonals; V is evaluated at every grid
+    point.
+
+    Parameters
+    ----------
+    x : const arma::vec&
+        n values.
+
+    y : arma::vec&
+        H x, resized to n values if needed. Must not be x.
+    */
+
+    double h2 = step*step;
+    if ((int) y.n_elem != n) y.set_size(n);
+
+    for (int i = 0; i < n; i++)
+    {
+        double neighbours = 0;
+        if (i > 0)     neighbours += x(i - 1);
+        if (i < n - 1) neighbours += x(i + 1);
+        y(i) = (2/h2 + potential(rho(i)))*x(i) - neighbours/h2;
+    }
+}
+
+
+arma::vec RadialHamiltonian::diagonal() const
+{
+    arma::vec diag(n);
+
+    for (int i = 0; i < n; i++)
+    {   // creating the diagonal elements
+        diag(i) = 2/(step*step) + potential(rho(i));
+    }
+
+    return diag;
+}
+
+
+arma::vec RadialHamiltonian::off_diagonal(int k) const
+{
+    /*
+    -1/step^2 for k = 1. There are no other off-diagonals.
+    */
+
+    if (k != 1)
+    {
+        throw std::out_of_range("RadialHamiltonian has bandwidth 1");
+    }
+
+    arma::vec off_diag(n - 1);
+    off_diag.fill(-1/(step*step));
+
+    return off_diag;
+}
+
+
+HarmonicOscillatorHamiltonian::HarmonicOscillatorHamiltonian(int n_input,
+    double rho_min_input, double rho_max_input, double freq_input)
+    : RadialHamiltonian(n_input, rho_min_input, rho_max_input)
+{
+    freq = freq_input;
+}
+
+
+double HarmonicOscillatorHamiltonian::potential(double rho) const
+{
+    return freq*freq*rho*rho;
+}
+
+
+CoulombHamiltonian::CoulombHamiltonian(int n_input, double rho_min_input,
+    double rho_max_input, double freq_input)
+    : RadialHamiltonian(n_input, rho_min_input, rho_max_input)
+{
+    freq = freq_input;
+}
+
+
+double CoulombHamiltonian::potential(double rho) const
+{
+    return freq*freq*rho*rho + 1/rho;
+}
@@ -0,0 +1,117 @@
+#ifndef HAMILTONIAN_OPERATOR_H
+#define HAMILTONIAN_OPERATOR_H
+
+#include <armadillo>
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+
+class HamiltonianOperator
+{
+    /*
+    Interface for a symmetric band matrix which is never stored, only
+    applied to vectors and read by diagonals. The EigenSolver backends take
+    the diagonal and the first off-diagonal of a tridiagonal operator, see
+    EigenSolver::solve, banded_eig takes the band storage of any bandwidth,
+    and only the Jacobi backend forms the dense matrix. The memory is then
+    O(n) for the diagonals plus what the solver needs, instead of the n^2 of
+    construct_diag_matrix.
+
+    An implementation gives the following.
+
+        size            the dimension n.
+        bandwidth       the number of super-diagonals b, 1 for tridiagonal.
+        apply           y = H x, O(n b).
+        diagonal        H(i, i), n values.
+        off_diagonal    H(i, i + k) for k = 1, ..., b, n - k values.
+    */
+public:
+    virtual ~HamiltonianOperator() {}
+
+    virtual int size() const = 0;
+    virtual int bandwidth() const = 0;
+    virtual void apply(const arma::vec& x, arma::vec& y) const = 0;
+    virtual arma::vec diagonal() const = 0;
+    virtual arma::vec off_diagonal(int k = 1) const = 0;
+
+    arma::mat band() const;
+    arma::mat dense() const;
+    double residual(double eigenvalue, const arma::vec& x) const;
+};
+
+
+class RadialHamiltonian : public HamiltonianOperator
+{
+    /*
+    -u'' + V(rho) u with the 3-point stencil on the grid of the drivers,
+    rho_i = rho_min + i*step, i = 0, ..., n-1, step = (rho_max - rho_min)/n,
+    where u is zero at rho_min - step and rho_max. Only n, rho_min and step
+    are stored, and V is evaluated when needed, so the operator itself is
+    O(1) in memory. The diagonal is 2/step^2 + V(rho_i) and the off-diagonal
+    -1/step^2.
+
+    Parameters
+    ----------
+    n : int
+        Number of grid points.
+
+    rho_min : double
+        First grid point.
+
+    rho_max : double
+        Where the potential ends.
+    */
+protected:
+    int n;
+    double rho_min;
+    double step;
+
+public:
+    RadialHamiltonian(int n_input, double rho_min_input, double rho_max_input);
+
+    virtual double potential(double rho) const = 0;
+
+    int size() const override;
+    int bandwidth() const override;
+    void apply(const arma::vec& x, arma::vec& y) const override;
+    arma::vec diagonal() const override;
+    arma::vec off_diagonal(int k = 1) const override;
+
+    double rho(int i) const;
+    double step_size() const;
+};
+
+
+class HarmonicOscillatorHamiltonian : public RadialHamiltonian
+{
+    /*
+    The single electron in quantum_dots.cpp, V(rho) = freq^2 rho^2, with
+    freq = 1 by default.
+    */
+private:
+    double freq;
+
+public:
+    HarmonicOscillatorHamiltonian(int n_input, double rho_min_input,
+        double rho_max_input, double freq_input = 1);
+    double potential(double rho) const override;
+};
+
+
+class CoulombHamiltonian : public RadialHamiltonian
+{
+    /*
+    The relative motion of the two electrons in quantum_dots_two_electrons.cpp,
+    V(rho) = freq^2 rho^2 + 1/rho.
+    */
+private:
+    double freq;
+
+public:
+    CoulombHamiltonian(int n_input, double rho_min_input, double rho_max_input,
+        double freq_input);
+    double potential(double rho) const override;
+};
+
+#endif
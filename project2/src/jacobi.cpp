@@ -1,5 +1,9 @@
 #include "jacobi.h"
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 
 arma::mat construct_diag_matrix(int n)
 {
@@ -215,12 +219,172 @@ void transform(int n, arma::mat& A, arma::mat& R, int idx_row, int idx_col)
 }
 
 
+void transform_lower(int n, arma::mat& A, arma::mat& R, int idx_row, int idx_col)
+{
+    /*
+    Same rotation as transform, but only the lower triangle of A, elements
+    A(i, j) with i >= j, is read and updated. The upper triangle is left as it
+    was.
+
+    transform updates rows k and l of the column-major A, which have stride n,
+    as well as columns k and l. Here, with k < l, only the part of row k left
+    of the diagonal, k elements, and of row l, l elements, are strided, while
+    columns k and l below the diagonal are contiguous. This is about half the
+    memory traffic of transform for pairs spread over the matrix. R is
+    rotated in a separate loop over two contiguous columns, which the compiler
+    vectorizes. For idx_row < idx_col, which is what find_max and
+    OffDiagonalMax give, the lower triangle and R are identical to those of
+    transform.
+
+    Parameters
+    ----------
+    A : arma::mat&
+        Reference to matrix A, of which only the lower triangle is used.
+
+    R : arma::mat&
+        Reference to eigenvector matrix R.
+
+    idx_row : int
+        The index k of one of the unit vectors that are used in the rotation.
+
+    idx_col : int
+        The index l of the other unit vector that are used in the rotation.
+    */
+
+    // the pair is normalized to k < l. Swapping the indices changes the sign
+    // of tau and theta, which gives the same rotation, except for a_kk == a_ll
+    // (tau = 0), where t = 1 either way and the angle has the opposite sign
+    // of that of transform with idx_row > idx_col
+    int k = std::min(idx_row, idx_col);
+    int l = std::max(idx_row, idx_col);
+
+    double a_kk = A(k, k);
+    double a_ll = A(l, l);
+    double a_lk = A(l, k);
+
+    double tau = (a_ll - a_kk)/(2*a_lk); // tau = cot(2*theta), see transform
+    double t;
+    
+    // to counteract numerical precision errors when tau is large
+    if (tau >= 0)
+    {
+        t = 1.0/(tau + std::sqrt(1 + tau*tau));
+    }
+    else
+    {
+        t = -1.0/(-tau + std::sqrt(1 + tau*tau));
+    }
+    
+    double c = 1/std::sqrt(1 + t*t);
+    double s = t*c;
+
+    double* a_k = A.colptr(k);
+    double* a_l = A.colptr(l);
+
+    for (int i = 0; i < k; i++)
+    {   // A(k, i) and A(l, i), both in column i
+        double* a_i = A.colptr(i);
+        double a_ki = a_i[k];
+        double a_li = a_i[l];
+        a_i[k] = a_ki*c - a_li*s;
+        a_i[l] = a_li*c + a_ki*s;
+    }
+
+    for (int i = k + 1; i < l; i++)
+    {   // A(i, k) in column k and A(l, i) in column i
+        double* a_i = A.colptr(i);
+        double a_ki = a_k[i];
+        double a_li = a_i[l];
+        a_k[i] = a_ki*c - a_li*s;
+        a_i[l] = a_li*c + a_ki*s;
+    }
+
+    for (int i = l + 1; i < n; i++)
+    {   // A(i, k) and A(i, l), contiguous
+        double a_ki = a_k[i];
+        double a_li = a_l[i];
+        a_k[i] = a_ki*c - a_li*s;
+        a_l[i] = a_li*c + a_ki*s;
+    }
+
+    a_k[l] = 0; // by virtue of the algorithm
+    a_k[k] = a_kk*c*c - 2*a_lk*c*s + a_ll*s*s;
+    a_l[l] = a_ll*c*c + 2*a_lk*c*s + a_kk*s*s;
+
+    double* __restrict r_k = R.colptr(k);
+    double* __restrict r_l = R.colptr(l);
+
+    for (int i = 0; i < n; i++)
+    {   // columns k and l of R
+        double r_ik = r_k[i];
+        double r_il = r_l[i];
+        r_k[i] = c*r_ik - s*r_il;
+        r_l[i] = c*r_il + s*r_ik;
+    }
+}
+
+
 arma::mat find_eig(int n, arma::mat& A, double tol_off_diag)
+{
+    /*
+    Finds the eigenvalues of matrix A. Uses OffDiagonalMax to keep track of the
+    largest off-diagonal element, O(n) per rotation instead of the O(n^2) of
+    find_max. Uses transform_lower to eliminate off-diagonal elements, and
+    copies the lower triangle to the upper one at the end. Repeats the
+    process untill all off-diagonal elements are smaller than tol_off_diag.
+    A must be symmetric.
+
+    Creates a matrix R, for storing eigenvectors.
+
+    Parameters
+    ----------
+    n : int
+        Dimension of array.
+
+    A : arma::mat&
+        Reference to matrix.
+
+    tol_off_diag : double
+        Tolerance for the largest allowed value of the off-diagonal elements.
+    */
+
+    arma::mat R(n, n);      // matrix for storing the eigenvectors of A
+    R.zeros();
+    R.diag(0) += 1;
+    
+    OffDiagonalMax tracker(n, A);
+
+    int idx_row;
+    int idx_col;
+    double max_val = tracker.find_max(idx_row, idx_col);
+    
+    while (max_val > tol_off_diag)
+    {
+        transform_lower(n, A, R, idx_row, idx_col);
+        tracker.update(idx_row, idx_col);
+        max_val = tracker.find_max(idx_row, idx_col);
+    }
+
+    for (int col = 0; col < n; col++)
+    {   // making A symmetric again
+        for (int row = col + 1; row < n; row++)
+        {
+            A(col, row) = A(row, col);
+        }
+    }
+
+    return R;
+}
+
+
+arma::mat find_eig_brute_force(int n, arma::mat& A, double tol_off_diag)
 {
     /*
     Finds the eigenvalues of matrix A. Uses find_max to locate the largest value
-    in the array. Uses transform to eliminate off-diagonal elements. Repeats the
-    process untill all diagonal elements are smaller than tol_off_diag.
+    in the array, which costs O(n^2) per rotation. Kept for comparison with
+    find_eig, which does the same rotations. Uses transform to eliminate
+    off-diagonal elements. Repeats the process untill all diagonal elements
+    are smaller than tol_off_diag.
 
     Creates a matrix R, for storing eigenvectors.
 
@@ -254,6 +418,385 @@ arma::mat find_eig(int n, arma::mat& A, double tol_off_diag)
 }
 
 
+double off_diag_norm(int n, const arma::mat& A)
+{
+    /*
+    Frobenius norm of the off-diagonal elements of A,
+    sqrt(sum_{i != j} A(i, j)^2).
+
+    Parameters
+    ----------
+    n : int
+        Dimension of matrix.
+
+    A : const arma::mat&
+        Reference to matrix.
+    */
+
+    double sum = 0;
+
+    for (int col = 0; col < n; col++)
+    {   // column-major, so the inner loop is contiguous
+        const double* column = A.colptr(col);
+        
+        for (int row = 0; row < n; row++)
+        {
+            if (row != col) sum += column[row]*column[row];
+        }
+    }
+
+    return std::sqrt(sum);
+}
+
+
+arma::mat find_eig_cyclic(int n, arma::mat& A, double tol_off_diag, int max_sweeps)
+{
+    /*
+    Finds the eigenvalues of the symmetric matrix A with the cyclic Jacobi
+    method in parallel order. Instead of the largest element, every
+    off-diagonal element is eliminated once per sweep. The n(n - 1)/2 pairs
+    are ordered as a round-robin (chess tournament) in n - 1 steps of n/2
+    pairs which have no index in common, so the rotations of a step commute
+    and are applied at the same time: first to the columns of A and R, then to
+    the rows of A. Both loops are split across threads with OpenMP, so the
+    method scales with the number of cores, which find_eig can not since it
+    does one rotation at a time.
+
+    The sweeps are repeated untill the Frobenius norm of the off-diagonal
+    elements is smaller than tol_off_diag, which is stricter than the largest
+    element criterion of find_eig. Convergence is quadratic, usually 6-10
+    sweeps.
+
+    Creates a matrix R, for storing eigenvectors.
+
+    Parameters
+    ----------
+    n : int
+        Dimension of array.
+
+    A : arma::mat&
+        Reference to matrix. Overwritten, the eigenvalues are on the diagonal
+        afterwards.
+
+    tol_off_diag : double
+        Tolerance for the Frobenius norm of the off-diagonal elements.
+
+    max_sweeps : int
+        Largest number of sweeps. Defaults to 100.
+
+    Returns
+    -------
+    R : arma::mat
+        Eigenvectors, column i belongs to A(i, i).
+    */
+
+    arma::mat R(n, n);      // matrix for storing the eigenvectors of A
+    R.zeros();
+    R.diag(0) += 1;
+
+    int players = n + (n % 2);      // an odd n gets a dummy index n, which sits out
+    int num_pairs = players/2;
+    
+    std::vector<int> order(players);
+    std::vector<int> pair_p(num_pairs);
+    std::vector<int> pair_q(num_pairs);
+    std::vector<double> pair_c(num_pairs);
+    std::vector<double> pair_s(num_pairs);
+
+    for (int sweep = 0; sweep < max_sweeps; sweep++)
+    {
+        if (off_diag_norm(n, A) < tol_off_diag) break;
+
+        for (int i = 0; i < players; i++)
+        {
+            order[i] = i;
+        }
+
+        for (int step = 0; step < players - 1; step++)
+        {   // one round of the tournament
+            int pairs = 0;
+
+            for (int i = 0; i < num_pairs; i++)
+            {   // first against last, second against second last, ...
+                int p = std::min(order[i], order[players - 1 - i]);
+                int q = std::max(order[i], order[players - 1 - i]);
+                
+                if (q == n) continue;       // the dummy index
+
+                double a_pq = A(p, q);
+                double c = 1;
+                double s = 0;
+
+                if (a_pq != 0)
+                {   // same angle as in transform
+                    double tau = (A(q, q) - A(p, p))/(2*a_pq);
+                    double t;
+                    
+                    if (tau >= 0)
+                    {
+                        t = 1.0/(tau + std::sqrt(1 + tau*tau));
+                    }
+                    else
+                    {
+                        t = -1.0/(-tau + std::sqrt(1 + tau*tau));
+                    }
+
+                    c = 1/std::sqrt(1 + t*t);
+                    s = t*c;
+                }
+
+                pair_p[pairs] = p;
+                pair_q[pairs] = q;
+                pair_c[pairs] = c;
+                pair_s[pairs] = s;
+                pairs++;
+            }
+
+            #pragma omp parallel for schedule(static)
+            for (int k = 0; k < pairs; k++)
+            {   // A J and R J, the pairs touch different columns
+                double c = pair_c[k];
+                double s = pair_s[k];
+                double* a_p = A.colptr(pair_p[k]);
+                double* a_q = A.colptr(pair_q[k]);
+                double* r_p = R.colptr(pair_p[k]);
+                double* r_q = R.colptr(pair_q[k]);
+
+                for (int i = 0; i < n; i++)
+                {
+                    double a_ip = a_p[i];
+                    a_p[i] = c*a_ip - s*a_q[i];
+                    a_q[i] = s*a_ip + c*a_q[i];
+
+                    double r_ip = r_p[i];
+                    r_p[i] = c*r_ip - s*r_q[i];
+                    r_q[i] = s*r_ip + c*r_q[i];
+                }
+            }
+
+            #pragma omp parallel for schedule(static)
+            for (int col = 0; col < n; col++)
+            {   // J^T (A J), every column is rotated by all pairs
+                double* a_col = A.colptr(col);
+                
+                for (int k = 0; k < pairs; k++)
+                {
+                    double c = pair_c[k];
+                    double s = pair_s[k];
+                    double a_pj = a_col[pair_p[k]];
+                    a_col[pair_p[k]] = c*a_pj - s*a_col[pair_q[k]];
+                    a_col[pair_q[k]] = s*a_pj + c*a_col[pair_q[k]];
+                }
+            }
+
+            for (int k = 0; k < pairs; k++)
+            {   // zero by virtue of the algorithm
+                A(pair_p[k], pair_q[k]) = A(pair_q[k], pair_p[k]) = 0;
+            }
+
+            // rotating all but the first index one place
+            int last = order[players - 1];
+            for (int i = players - 1; i > 1; i--)
+            {
+                order[i] = order[i - 1];
+            }
+            if (players > 1) order[1] = last;
+        }
+    }
+
+    return R;
+}
+
+
+OffDiagonalMax::OffDiagonalMax(int n_input, const arma::mat& A_input)
+    : n(n_input), A(A_input)
+{
+    /*
+    Scans all rows of A and builds the tournament tree, O(n^2). A is kept as a
+    reference, and must be updated with transform before every call to
+    update.
+
+    Parameters
+    ----------
+    n_input : int
+        Dimension of matrix.
+
+    A_input : const arma::mat&
+        Reference to the symmetric matrix.
+    */
+
+    leaves = 1;
+    while (leaves < n) leaves *= 2;
+
+    // rows past n are padding which never wins
+    row_max.assign(leaves, -1);
+    row_max_col.assign(leaves, -1);
+    tree.resize(2*leaves);
+
+    for (int row = 0; row < n; row++)
+    {
+        scan_row(row);
+    }
+
+    for (int i = 0; i < leaves; i++)
+    {
+        tree[leaves + i] = i;
+    }
+
+    for (int node = leaves - 1; node >= 1; node--)
+    {
+        tree[node] = winner(tree[2*node], tree[2*node + 1]);
+    }
+}
+
+
+void OffDiagonalMax::scan_row(int row)
+{
+    /*
+    Finds the largest |A(row, col)|, col > row. A is symmetric, so the row is
+    read as the contiguous part of column row below the diagonal.
+    */
+
+    const double* column = A.colptr(row);
+    double max_val = 0;
+    int max_col = -1;
+
+    for (int col = row + 1; col < n; col++)
+    {
+        double matrix_element = fabs(column[col]);
+        
+        if (matrix_element > max_val)
+        {
+            max_val = matrix_element;
+            max_col = col;
+        }
+    }
+
+    row_max[row] = max_val;
+    row_max_col[row] = max_col;
+}
+
+
+int OffDiagonalMax::winner(int row_a, int row_b) const
+{
+    /*
+    The row with the largest maximum, the first one if they are equal.
+    */
+
+    if (row_max[row_b] > row_max[row_a])
+    {
+        return row_b;
+    }
+    if ((row_max[row_b] == row_max[row_a]) && (row_b < row_a))
+    {
+        return row_b;
+    }
+    return row_a;
+}
+
+
+void OffDiagonalMax::update_row(int row)
+{
+    /*
+    Replays the matches on the path from the leaf of row to the root.
+    */
+
+    for (int node = (leaves + row)/2; node >= 1; node /= 2)
+    {
+        tree[node] = winner(tree[2*node], tree[2*node + 1]);
+    }
+}
+
+
+double OffDiagonalMax::find_max(int& idx_row, int& idx_col) const
+{
+    /*
+    Finds the max value of the off-diagonal elements of the matrix, O(1).
+
+    Parameters
+    ----------
+    idx_row : int&
+        Reference to row index value where the row index of the maximum value
+        will be stored.
+
+    idx_col : int&
+        Reference to column index value where the column index of the maximum
+        value will be stored, idx_col > idx_row.
+
+    Returns
+    -------
+    max_val : double
+        The maximum absolute value of the off-diagonal elements.
+    */
+
+    int row = tree[1];
+    idx_row = row;
+    idx_col = row_max_col[row];
+
+    return row_max[row];
+}
+
+
+void OffDiagonalMax::update(int idx_row, int idx_col)
+{
+    /*
+    Updates the row maxima and the tree after transform has rotated A in the
+    plane of idx_row and idx_col.
+
+    Parameters
+    ----------
+    idx_row : int
+        The index k of one of the unit vectors that were used in the rotation.
+
+    idx_col : int
+        The index l of the other unit vector that were used in the rotation.
+    */
+
+    int k = std::min(idx_row, idx_col);
+    int l = std::max(idx_row, idx_col);
+
+    for (int row = 0; row < l; row++)
+    {   // rows above l, where only elements (k, row) and (l, row) changed
+        if (row == k) continue;
+
+        int old_col = row_max_col[row];
+        double old_max = row_max[row];
+
+        if (((old_col == k) || (old_col == l)) && (fabs(A(old_col, row)) < old_max))
+        {   // the maximum decreased, and may have moved anywhere in the row
+            scan_row(row);
+        }
+        else
+        {   // the maximum is either unchanged or one of the two new elements
+            if (old_col >= 0) row_max[row] = fabs(A(old_col, row));
+            for (int col : {k, l})
+            {
+                if (col <= row) continue;
+                
+                double matrix_element = fabs(A(col, row));
+                
+                if ((matrix_element > row_max[row]) ||
+                    ((matrix_element == row_max[row]) && (col < row_max_col[row])))
+                {
+                    row_max[row] = matrix_element;
+                    row_max_col[row] = col;
+                }
+            }
+        }
+
+        if ((row_max[row] != old_max) || (row_max_col[row] != old_col))
+        {
+            update_row(row);
+        }
+    }
+
+    scan_row(k);
+    scan_row(l);
+    update_row(k);
+    update_row(l);
+}
+
+
 void test_function_for_checking_header_implementation()
 {
     std::cout << "it works" << std::endl;
@@ -5,6 +5,7 @@
 #include <cmath>
 #include <iostream>
 #include <fstream>
+#include <vector>
 
 
 arma::mat construct_diag_matrix(int n);
@@ -12,9 +13,54 @@ arma::mat construct_diag_matrix(int n, double off_diag, double diag);
 arma::mat construct_diag_matrix(int n, double off_diag, arma::vec diag);
 double find_max(int n, arma::mat& A, int& idx_row, int& idx_col);
 void transform(int n, arma::mat& A, arma::mat& R, int idx_row, int idx_col);
+void transform_lower(int n, arma::mat& A, arma::mat& R, int idx_row, int idx_col);
 arma::mat find_eig(int n, arma::mat& A, double tol_off_diag);
+arma::mat find_eig_brute_force(int n, arma::mat& A, double tol_off_diag);
+arma::mat find_eig_cyclic(int n, arma::mat& A, double tol_off_diag,
+    int max_sweeps = 100);
+double off_diag_norm(int n, const arma::mat& A);
 void test_function_for_checking_header_implementation();
 
+
+class OffDiagonalMax
+{
+    /*
+    Keeps track of the largest off-diagonal element of a symmetric matrix
+    during Jacobi rotations, so that it does not have to be searched for in all
+    n^2 elements after every rotation as find_max does.
+
+    For every row i the column j > i of the largest |A(i, j)| is stored, and a
+    tournament tree over the rows holds the row with the largest of these. A
+    rotation in the (k, l) plane only changes rows and columns k and l, so
+    update rescans rows k and l and checks the two changed elements of the
+    other rows, O(n) per rotation. Only a row whose maximum was in column k or
+    l and decreased has to be rescanned as well, which is rare.
+
+    Ties are broken as in find_max, i.e., the first element in row-major order,
+    so for a symmetric matrix find_eig does exactly the same rotations as
+    find_eig_brute_force.
+
+    Only the lower triangle of A is read, so A may be rotated with either
+    transform or transform_lower.
+    */
+private:
+    int n;
+    int leaves;                         // number of leaves, power of two >= n
+    const arma::mat& A;
+    std::vector<double> row_max;        // largest |A(i, j)|, j > i, per row
+    std::vector<int> row_max_col;       // column of row_max
+    std::vector<int> tree;              // tournament tree, tree[1] is the winner
+
+    void scan_row(int row);
+    void update_row(int row);
+    int winner(int row_a, int row_b) const;
+
+public:
+    OffDiagonalMax(int n_input, const arma::mat& A_input);
+    double find_max(int& idx_row, int& idx_col) const;
+    void update(int idx_row, int idx_col);
+};
+
 const double pi = 3.14159265358979323846;
 
 #endif
\ No newline at end of file
@@ -1,36 +1,11 @@
 #include "jacobi.h"
+#include "eigen_solver.h"
+#include "richardson.h"
+#include "banded_hamiltonian.h"
 #include <iomanip>
 #include <string>
 
 
-arma::vec effective_potential(int grid, double step, double rho_min)
-{
-    /*
-    Creates a vector containing correct diagonal elements for task 2d.
-
-    Parameters
-    ----------
-    n : int
-        Grid size.
-
-    step : double
-        Step size.
-
-    rho_min : double
-        Minimum rho value.
-    */
-
-    arma::vec diag(grid);
-
-    for (int i = 0; i < grid; i++)
-    {   // creating the diagonal elements
-        diag(i) = 2/(step*step) + (rho_min + i*step)*(rho_min + i*step);
-    }
-
-    return diag;
-}
-
-
 class QuantumData
 {
     /* NEED TO COMMENT!*/
@@ -39,12 +14,11 @@ private:
     bool looping_grid = false; // boolean for toggling progress of grid info on/off
     bool looping_freq = false; // boolean for toggling progress of frequency info on/off
     double eig;                // analytical eigenvalue
-    double step;
-    double off_diag;
     int grid       = 100;      // grid size
     double rho_min = std::pow(10, -7);
     double rho_max = 5;        // approximating infinity
-    double tol_off_diag = std::pow(10, -10); // tolerance for Jacobi
+    std::unique_ptr<EigenSolver> solver = make_eigen_solver("auto");
+    std::string stencil = "3-point";    // finite difference of loop_rho
 
     // loop-specific values
     double rho_tmp = rho_max; // for reverting rho_max to original max value
@@ -118,6 +92,43 @@ public:
         num_rho = (rho_end - rho_max)/d_rho;
     }
 
+    void set_solver(std::string name)
+    {   /*
+        For choosing the eigen solver backend. If not called, "auto" is used,
+        which picks the fastest backend for every grid size.
+
+        Parameters
+        ----------
+        name : std::string
+            "jacobi", "ql", "lapack", "lanczos" or "auto", see EigenSolver.
+        */
+        solver = make_eigen_solver(name);
+    }
+
+    void set_stencil(std::string stencil_input)
+    {   /*
+        For choosing the finite difference of loop_rho. If not called, the
+        3-point stencil on the grid starting at rho_min is used with the
+        eigen solver of set_solver. "5-point", "7-point" and "numerov" use
+        the banded Hamiltonians of banded_hamiltonian.cpp, with the boundary
+        at rho = 0 on the grid, and reach 4 digits with about 100, 50 and
+        100 grid points. The default grid has an O(h) error, and needs about
+        6*10^4 points for 4 digits, see compare_stencils in
+        benchmark_jacobi.cpp.
+
+        Parameters
+        ----------
+        stencil_input : std::string
+            "3-point", "5-point", "7-point" or "numerov".
+        */
+        if ((stencil_input != "3-point") && (stencil_input != "5-point")
+            && (stencil_input != "7-point") && (stencil_input != "numerov"))
+        {
+            throw std::invalid_argument("unknown stencil " + stencil_input);
+        }
+        stencil = stencil_input;
+    }
+
     void set_progress_values(bool progress_input)
     {
         /* REMEMBER TO COMMENT*/
@@ -137,18 +148,18 @@ public:
         while (rho_max < rho_end)
         {            
             eig = 3;    // initial analytical eigenvalue
-            step = (rho_max - rho_min)/grid;
-            off_diag = -1/(step*step);
+            arma::vec sorted_diag;
 
-            // constructing vector for the diagonal elements            
-            arma::vec diag = effective_potential(grid, step, rho_min);
-
-            // constructing tri-diagonal matrix
-            arma::mat A = construct_diag_matrix(grid, off_diag, diag);
-            
-            // using Jacobis method to extract the eigenvalues of the tri-diagonal matrix
-            arma::mat R = find_eig(grid, A, tol_off_diag);
-            arma::vec sorted_diag = arma::sort(A.diag(0));
+            if (stencil == "3-point")
+            {   // the lowest eigenvalues of the tri-diagonal matrix
+                HarmonicOscillatorHamiltonian H(grid, rho_min, rho_max);
+                sorted_diag = solver->solve(H, num_eig);
+            }
+            else
+            {   // the lowest eigenvalues of the banded matrix
+                sorted_diag = radial_eigenvalues(stencil, grid, rho_max,
+                    [](double rho) { return rho*rho; }, num_eig);
+            }
 
             if (progress)
             {   // for printing progress data
@@ -191,6 +202,94 @@ public:
         }
     }
 
+    void extrapolate_rho(double tol = 1e-8, int grid_max = 102400)
+    {   /*
+        Loops over the same rho_max values as loop_rho, but extrapolates the
+        eigenvalues to step size 0 instead of using a single grid. For every
+        rho_max the grid starts at the current grid value and is doubled until
+        the relative error estimate of RichardsonExtrapolation is below tol
+        for all num_eig eigenvalues, or the grid would exceed grid_max. The
+        O(h) error of this grid is then gone after about six solves, with
+        n <= 1600 for tol = 1e-8, instead of the 10^5 points needed for
+        1e-3 without extrapolation. The remaining error is that of the finite
+        rho_max.
+
+        The results are appended to "eigenvalues_extrapolated.txt". The file
+        starts with the number of eigenvalues per rho_max and the number of
+        rho_max values, followed by the columns extrapolated eigenvalue, error
+        estimate, exact eigenvalue, error, rho_max and the largest grid used.
+
+        Parameters
+        ----------
+        tol : double
+            Relative tolerance of the extrapolated eigenvalues. Defaults to
+            1e-8.
+
+        grid_max : int
+            Largest grid. Defaults to 102400.
+        */
+
+        std::ofstream extrapolated_file;
+        extrapolated_file.open("eigenvalues_extrapolated.txt", std::ios_base::app);
+        extrapolated_file << num_eig << " " << num_rho << "\n";
+        extrapolated_file << std::setw(20) << "extrapolated";
+        extrapolated_file << std::setw(20) << "error estimate";
+        extrapolated_file << std::setw(20) << "exact";
+        extrapolated_file << std::setw(20) << "error";
+        extrapolated_file << std::setw(20) << "rho_max";
+        extrapolated_file << std::setw(20) << "n\n";
+
+        if (progress)
+        {   // progress information
+            std::cout << "extrapolating over rho max" << std::endl;
+        }
+
+        RichardsonExtrapolation extrapolation;
+
+        while (rho_max < rho_end)
+        {
+            extrapolation.clear();
+            int grid_level = grid;
+
+            while (true)
+            {   // halving the step size until converged
+                HarmonicOscillatorHamiltonian H(grid_level, rho_min, rho_max);
+                extrapolation.add(H.step_size(), solver->solve(H, num_eig));
+
+                if (extrapolation.converged(tol) || (2*grid_level > grid_max)) break;
+                grid_level *= 2;
+            }
+
+            arma::vec eigenvalues = extrapolation.extrapolated();
+            arma::vec error       = extrapolation.error_estimate();
+
+            if (progress)
+            {   // for printing progress data
+                std::cout << "rho_max: " << rho_max << " rho_end: ";
+                std::cout << rho_end << "  ";
+                std::cout << "levels: " << extrapolation.levels() << " n: ";
+                std::cout << grid_level << std::endl;
+            }
+
+            eig = 3;    // initial analytical eigenvalue
+            for (int i = 0; i < num_eig; i++)
+            {   // writing data to file
+                extrapolated_file << std::setw(20) << std::setprecision(14) << eigenvalues(i);
+                extrapolated_file << std::setw(20) << std::setprecision(4) << error(i);
+                extrapolated_file << std::setw(20) << std::setprecision(10) << eig;
+                extrapolated_file << std::setw(20) << std::setprecision(10) << fabs(eig - eigenvalues(i));
+                extrapolated_file << std::setw(20) << rho_max;
+                extrapolated_file << std::setw(20) << grid_level;
+                extrapolated_file << "\n";
+                eig = eig + 4;
+            }
+            rho_max = rho_max + d_rho;
+        }
+
+        rho_max = rho_tmp;
+        extrapolated_file.close();
+    }
+
     ~QuantumData()
     {
         data_file.close();
@@ -203,7 +302,9 @@ int main()
     QuantumData q;
     q.set_grid_values(100, 101, 10);
     q.set_rho_values(1, 7, 0.1);
+    // q.set_stencil("7-point");
     q.loop_grid();
+    // q.extrapolate_rho(1e-8);
 
     return 0;
 }
\ No newline at end of file
@@ -257,6 +257,96 @@ def approximate_eigenvectors(freq, rho):
     return (freq_e/np.pi)**(1/4)*np.exp(-(1/2)*freq_e*(rho - rho_0))
 
 
+def read_eigendata(filename):
+    """
+    Reads a binary file written by EigenWriter in eigen_writer.h. The file
+    starts with the 8 bytes "QDEIGV01", followed by records of an int64 n,
+    rho max, the eigenvalue and the n elements of the eigenvector, all in
+    native byte order.
+
+    Parameters
+    ----------
+    filename : str
+        Filename of file to be read, e.g., 'eigendata_omega_0.250000.bin'.
+
+    Returns
+    -------
+    rho : numpy.ndarray
+        The rho max values.
+
+    eigenvalue : numpy.ndarray
+        The eigenvalue of each rho max.
+
+    eigenvectors : numpy.ndarray or list
+        The eigenvector of each rho max as the rows of a 2D array, or a list of
+        arrays if the grid size changes within the file.
+
+    Raises
+    ------
+    ValueError
+        Raised if input file is of incorrect formatting.
+    """
+
+    data = np.fromfile(filename, dtype=np.uint8)
+    if bytes(data[:8]) != b"QDEIGV01":
+        raise ValueError(f"{filename} is not an eigendata file.")
+
+    data = data[8:].view(np.float64)
+    if len(data) == 0:
+        return np.zeros(0), np.zeros(0), np.zeros((0, 0))
+
+    n = int(data[:1].view(np.int64)[0])
+    if len(data) % (n + 3) == 0:
+        records = data.reshape(-1, n + 3)
+        if np.all(records[:, 0].view(np.int64) == n):
+            # all records have the same grid size
+            return records[:, 1].copy(), records[:, 2].copy(), records[:, 3:].copy()
+
+    rho = []
+    eigenvalue = []
+    eigenvectors = []
+    i = 0
+    while i < len(data):
+        n = int(data[i:i+1].view(np.int64)[0])
+        if i + n + 3 > len(data):
+            raise ValueError(f"{filename} ends in the middle of a record.")
+        rho.append(data[i+1])
+        eigenvalue.append(data[i+2])
+        eigenvectors.append(data[i+3:i+3+n].copy())
+        i += n + 3
+
+    return np.array(rho), np.array(eigenvalue), eigenvectors
+
+
+def load_eigendata(name):
+    """
+    Reads the results of a scan, from 'eigendata_' + name + '.bin' if it
+    exists, and otherwise from the text files 'eigenvalue_' + name + '.txt'
+    and 'eigenvector_' + name + '.txt'.
+
+    Parameters
+    ----------
+    name : str
+        The filename given to compute_and_write_eigendata, e.g.,
+        'omega_0.250000'.
+
+    Returns
+    -------
+    rho, eigenvalue, eigenvectors
+        See read_eigendata.
+    """
+
+    try:
+        return read_eigendata("eigendata_" + name + ".bin")
+    except FileNotFoundError:
+        pass
+
+    rho, eigenvalue = np.loadtxt("eigenvalue_" + name + ".txt", skiprows=1, unpack=True)
+    eigenvectors = np.loadtxt("eigenvector_" + name + ".txt", skiprows=1)[:, 1:]
+
+    return rho, eigenvalue, eigenvectors
+
+
 def visualize_eigendata_two_electrons_numerical_and_analytical():
     """
     Reads eigenvalue file which contains two columns. The first column consists
@@ -269,8 +359,7 @@ def visualize_eigendata_two_electrons_numerical_and_analytical():
     and analytical results. freq = [0.05, 0.25].
     """
 
-    filenames_1 = ["eigenvalue_omega_0.050000.txt", "eigenvalue_omega_0.250000.txt"]
-    filenames_2 = ["eigenvector_omega_0.050000.txt", "eigenvector_omega_0.250000.txt"]
+    names = ["omega_0.050000", "omega_0.250000"]
     functions = [exact_freq_0_05, exact_freq_0_25]
     exact_eigenvalues = [2*0.1750, 2*0.6250]
     frequencies = [0.05, 0.25]
@@ -279,9 +368,9 @@ def visualize_eigendata_two_electrons_numerical_and_analytical():
 
         _, ax = plt.subplots()
 
+        rho, eigenvalue, eigenvectors = load_eigendata(names[i])
+
         # eigenvalue calculations
-        rho, eigenvalue = np.loadtxt(filenames_1[i], skiprows=1, unpack=True)
-        
         error = np.abs(eigenvalue - exact_eigenvalues[i])
         min_error_idx = np.argmin(error)
         min_error = error[min_error_idx]
@@ -291,7 +380,7 @@ def visualize_eigendata_two_electrons_numerical_and_analytical():
         
         print("eigenvalue data")
         print("===============")
-        print("filename: ", filenames_1[i])
+        print("filename: ", names[i])
         print("exact eigenvalue: ", exact_eigenvalues[i])
         print("best eigenvalue: ", eigenvalue[min_error_idx])
         print("best error: ", min_error)
@@ -302,15 +391,10 @@ def visualize_eigendata_two_electrons_numerical_and_analytical():
 
 
         # eigenvector calculations
-
-        eigenvectors     = np.loadtxt(filenames_2[i], skiprows=1)
-        num_rho_max      = np.shape(eigenvectors)[0]        # number of rho max values
-        num_eig_elements = np.shape(eigenvectors)[1] - 1    # number of elements in eigenvector
-
-        rhos, eigenvectors = eigenvectors[:, 0], eigenvectors[:, 1:]
+        num_eig_elements = len(eigenvectors[min_error_idx]) # number of elements in eigenvector
         eigenvectors[min_error_idx] /= np.sum(eigenvectors[min_error_idx]) # normalizing
 
-        rho = np.linspace(0, rhos[min_error_idx], num_eig_elements)
+        rho = np.linspace(0, rho[min_error_idx], num_eig_elements)
         exact_eigenvector  = functions[i](rho)
         exact_eigenvector /= np.sum(exact_eigenvector)
         
@@ -338,12 +422,8 @@ def visualize_eigendata_two_electrons_numerical():
     frequencies.
     """
 
-    filenames_1 = ["eigenvalue_omega_0.010000.txt", "eigenvalue_omega_0.050000.txt", 
-        "eigenvalue_omega_0.250000.txt", "eigenvalue_omega_0.500000.txt",
-        "eigenvalue_omega_1.000000.txt", "eigenvalue_omega_5.000000.txt"]
-    filenames_2 = ["eigenvector_omega_0.010000.txt", "eigenvector_omega_0.050000.txt",
-        "eigenvector_omega_0.250000.txt", "eigenvector_omega_0.500000.txt",
-        "eigenvector_omega_1.000000.txt", "eigenvector_omega_5.000000.txt"]
+    names = ["omega_0.010000", "omega_0.050000", "omega_0.250000",
+        "omega_0.500000", "omega_1.000000", "omega_5.000000"]
 
     frequencies = [0.01, 0.05, 0.25, 0.5, 1, 5]
 
@@ -352,16 +432,16 @@ def visualize_eigendata_two_electrons_numerical():
 
     for i in range(6):
 
+        rho, eigenvalue, eigenvectors = load_eigendata(names[i])
+
         # eigenvalue calculations
-        rho, eigenvalue = np.loadtxt(filenames_1[i], skiprows=1, unpack=True)
-        
         best_rho_idx = np.argmin(np.abs(eigenvalue[:-1] - eigenvalue[1:]))
 
         best_rho = rho[best_rho_idx]
 
         print("eigenvalue data")
         print("===============")
-        print("filename: ", filenames_1[i])
+        print("filename: ", names[i])
         print("best rho: ", best_rho)
         print("best rho idx: ", best_rho_idx)
         print("number of rhos: ", len(rho))
@@ -369,15 +449,10 @@ def visualize_eigendata_two_electrons_numerical():
 
 
         # eigenvector calculations
-
-        eigenvectors     = np.loadtxt(filenames_2[i], skiprows=1)
-        num_rho_max      = np.shape(eigenvectors)[0]        # number of rho max values
-        num_eig_elements = np.shape(eigenvectors)[1] - 1    # number of elements in eigenvector
-
-        rhos, eigenvectors = eigenvectors[:, 0], eigenvectors[:, 1:]
+        num_eig_elements = len(eigenvectors[best_rho_idx])  # number of elements in eigenvector
         eigenvectors[best_rho_idx] /= np.sum(eigenvectors[best_rho_idx]) # normalizing
 
-        rho = np.linspace(0, rhos[best_rho_idx], num_eig_elements)
+        rho = np.linspace(0, best_rho, num_eig_elements)
 
     
         ax.plot(rho, eigenvectors[best_rho_idx], label=f"$\omega_r: ${frequencies[i]}")
@@ -390,6 +465,40 @@ def visualize_eigendata_two_electrons_numerical():
     plt.show()
 
 
+def visualize_stencil_accuracy(filename="benchmark_stencils.csv"):
+    """
+    Reads the file written by compare_stencils in benchmark_jacobi.cpp, with
+    the columns method, n, median runtime in seconds and the largest relative
+    error of the lowest eigenvalues, and plots the error against the runtime
+    and against n for every finite difference method.
+
+    Parameters
+    ----------
+    filename : str
+        Name of the csv file.
+    """
+
+    data = np.genfromtxt(filename, delimiter=",", names=True, dtype=None,
+        encoding="utf-8")
+
+    _, (ax_time, ax_grid) = plt.subplots(1, 2)
+
+    for method in dict.fromkeys(data["method"]):
+        rows = data[data["method"] == method]
+        ax_time.loglog(rows["median"], rows["error"], "o-", label=method)
+        ax_grid.loglog(rows["n"], rows["error"], "o-", label=method)
+
+    ax_time.set_xlabel("time [s]", fontsize=40)
+    ax_grid.set_xlabel(r"$n$", fontsize=40)
+
+    for ax in (ax_time, ax_grid):
+        ax.set_ylabel("relative error", fontsize=40)
+        ax.tick_params(labelsize=30)
+        ax.grid()
+
+    ax_grid.legend(fontsize=30)
+    plt.show()
+
 
 if __name__ == "__main__":
     q = VisualizeData("eigenvalues.txt")
@@ -398,4 +507,5 @@ if __name__ == "__main__":
 
     visualize_eigendata_two_electrons_numerical_and_analytical()
     visualize_eigendata_two_electrons_numerical()
+    # visualize_stencil_accuracy()
     pass
\ No newline at end of file
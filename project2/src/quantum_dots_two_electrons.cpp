@@ -1,53 +1,27 @@
 #include "jacobi.h"
+#include "eigen_solver.h"
+#include "scan_scheduler.h"
+#include "eigen_writer.h"
 #include <iomanip>
 #include <string>
 
-arma::vec effective_potential(int grid, double step, double rho_min, double freq)
-{
-    /*
-    Creates a vector containing correct diagonal elements for task 2d.
-
-    Parameters
-    ----------
-    n : int
-        Grid size.
-
-    step : double
-        Step size.
-
-    rho_min : double
-        Minimum rho value.
-
-    freq : double
-        A freqency in front of the harmonic oscillator potential. 
-        For the case of two electrons this normalizes the constants in the 
-        coulomb potential and makes it unitless.
-    */
-
-    arma::vec diag_elements(grid);
-    for (int i = 0; i < grid; i++)
-    {   
-        // creating the diagonal elements
-        diag_elements(i) =   2/(step*step) 
-                  + freq*freq*(rho_min + i*step)*(rho_min + i*step) // Harmonic oscillator potential (with frequency)
-                  + 1/(rho_min + i*step);                     // Coulomb potential
-    }
-
-    return diag_elements;
-}
-
-
 int compute_and_write_eigendata(double freq, std::string filename, 
                                       bool progress, double rho_min, 
                                       double rho_max, int grid, 
-                                      double tol_off_diag, double rho_end, 
-                                      double d_rho)
+                                      double rho_end, double d_rho,
+                                      GroundStateContinuation& solver,
+                                      bool binary = false)
 {   
     /* 
     Computing eigenvalues and vectors for matrix approximating the Hamiltonian
     opetrator for a potential well with two electrons interacting with Coulomb
     force.
 
+    The matrix is symmetric tridiagonal, so only its diagonal and off-diagonal
+    are passed to solver, which finds the ground state. Neighbouring rho_max
+    values give almost the same ground state, so solver starts from the
+    previous one, see GroundStateContinuation.
+
     Parameters
     ----------
     freq : double
@@ -56,7 +30,8 @@ int compute_and_write_eigendata(double freq, std::string filename,
     filename : std::string
         Filename input. The final filename will be:
         "eigenvalue_" + filename + ".txt", for the file containing eigenvalues,
-        "eigenvector_" + filename + ".txt", for the file containing eigenvectors.
+        "eigenvector_" + filename + ".txt", for the file containing eigenvectors,
+        or "eigendata_" + filename + ".bin" for both if binary is true.
 
     progress : bool
         For toggling progress information on/off.
@@ -70,14 +45,19 @@ int compute_and_write_eigendata(double freq, std::string filename,
     grid : int
         This is the number of gridpoints.
 
-    tol_off_diag : double
-        The tolerance for jacobi method.
-
     rho_end : double
         Iteration stop value.
 
     d_rho : double
         Increment for rho_max.
+
+    solver : GroundStateContinuation&
+        Ground state solver, which remembers the last ground state between
+        calls.
+
+    binary : bool
+        If true, the results are written by an EigenWriter with a background
+        thread instead of to the text files. Defaults to false.
     */ 
 
     std::cout << "Looping over different rho_max values" << std::endl;
@@ -92,11 +72,20 @@ int compute_and_write_eigendata(double freq, std::string filename,
 
     filename_eig = "eigenvalue_" + filename + ".txt";
     filename_vec = "eigenvector_" + filename + ".txt";
-    data_file_eig.open(filename_eig, std::ios_base::app);
-    data_file_vec.open(filename_vec, std::ios_base::app);
+    std::unique_ptr<EigenWriter> writer;
+
+    if (binary)
+    {
+        writer.reset(new EigenWriter("eigendata_" + filename + ".bin", 8 << 20, true));
+    }
+    else
+    {
+        data_file_eig.open(filename_eig, std::ios_base::app);
+        data_file_vec.open(filename_vec, std::ios_base::app);
 
-    data_file_eig << std::setw(6) << "rho" << std::setw(20) << "eigenvalue" << std::endl;
-    data_file_vec << std::setw(20) << "rho | eigenvector ->" << std::endl;
+        data_file_eig << std::setw(6) << "rho" << std::setw(20) << "eigenvalue" << std::endl;
+        data_file_vec << std::setw(20) << "rho | eigenvector ->" << std::endl;
+    }
 
     while (rho_max <= rho_end)
     {
@@ -104,22 +93,12 @@ int compute_and_write_eigendata(double freq, std::string filename,
         Looping over interesting maximum values for rho (approximation of infinity).
         */
         
-        double step = (rho_max - rho_min)/grid; // Step size
-        double off_diag = -1/(step*step);       // Off-diagonal elements in the matrix we want the eigenvalues of.
-
-        // constructing vector for the diagonal elements            
-        arma::vec diag_elements = effective_potential(grid, step, rho_min, freq);
-
-        // constructing tri-diagonal matrix
-        arma::mat diag_matrix = construct_diag_matrix(grid, off_diag, diag_elements);
-        
-        // using Jacobis method to extract the eigenvalues of the tri-diagonal matrix
-        arma::mat eigenvectors = find_eig(grid, diag_matrix, tol_off_diag);
+        // the Hamiltonian is never stored, only its diagonals
+        CoulombHamiltonian H(grid, rho_min, rho_max, freq);
 
-        // The eigenvalues are not necessarily sorted, and we want the ground state.
-        arma::uvec sort_indices = arma::sort_index(diag_matrix.diag(0));
-        arma::vec sorted_diag = arma::sort(diag_matrix.diag(0));
-        arma::vec ground_state = eigenvectors.col(sort_indices(0));
+        // eigenvalue and eigenvector of the ground state only
+        arma::vec ground_state;
+        double eigenvalue = solver.solve(H, ground_state);
 
         if (progress)
         {   // for printing progress data
@@ -129,20 +108,36 @@ int compute_and_write_eigendata(double freq, std::string filename,
         }
         
         // Writing ground state eigenvector and value to file.
-        data_file_eig << std::setw(6) << rho_max << std::setw(20) << std::setprecision(10) << sorted_diag(0) << std::endl;
-        data_file_vec << std::setw(20) << rho_max;
-        
-        for (int j=0; j<grid; j++)
-        {   // writing eigenvector to file
-            data_file_vec << std::setw(20) << std::setprecision(10) << ground_state(j);
+        if (binary)
+        {
+            writer->write(rho_max, eigenvalue, ground_state);
+        }
+        else
+        {   // no flush per line
+            data_file_eig << std::setw(6) << rho_max << std::setw(20) << std::setprecision(10) << eigenvalue << '\n';
+            data_file_vec << std::setw(20) << rho_max;
+
+            for (int j=0; j<grid; j++)
+            {   // writing eigenvector to file
+                data_file_vec << std::setw(20) << std::setprecision(10) << ground_state(j);
+            }
+            data_file_vec << '\n';
         }
         
         rho_max = rho_max + d_rho;
-        data_file_vec << std::endl;
     }
     rho_max = rho_tmp;
-    data_file_eig.close();
-    data_file_vec.close();
+    if (binary)
+    {
+        writer->close();
+    }
+    else
+    {
+        data_file_eig.close();
+        data_file_vec.close();
+    }
+
+    return 0;
 }
 
 
@@ -158,14 +153,33 @@ class Eigendata
     */
 private:
     bool progress = true;        // toggling progress info on/off
-    int grid = 200;              // end grid value
+    int grid = 200;              // number of grid points
     double rho_min = std::pow(10, -7);
-    double tol_off_diag = std::pow(10, -10); // tolerance for Jacobi
     double rho_max;
     double rho_end;
     double d_rho;
     double freq;
     std::string filename;
+    GroundStateContinuation solver;
+    ScanScheduler scheduler;
+    bool parallel = false;       // queueing the scans for run_scans
+    bool binary = false;         // EigenWriter instead of text files
+
+    void scan()
+    {   /*
+        Computes the scan given by the current parameters, or queues it if
+        parallel is set.
+        */
+        if (parallel)
+        {
+            scheduler.add_scan(freq, rho_max, rho_end, d_rho, grid, filename);
+        }
+        else
+        {
+            compute_and_write_eigendata(freq, filename, progress, rho_min,
+                rho_max, grid, rho_end, d_rho, solver, binary);
+        }
+    }
 
 public:
     Eigendata()
@@ -173,6 +187,95 @@ public:
 
     }
 
+    void set_solver(std::string name)
+    {   /*
+        For choosing the eigen solver backend of the cold solves. If not
+        called, "auto" is used, which picks the fastest backend for every grid
+        size.
+
+        Parameters
+        ----------
+        name : std::string
+            "jacobi", "ql", "lapack", "lanczos" or "auto", see EigenSolver.
+        */
+        solver.set_solver(name);
+        scheduler.set_solver(name);
+    }
+
+    void set_warm_start(bool warm_start)
+    {   /*
+        For toggling the continuation on/off. If not called, every rho_max and
+        frequency starts from the previous ground state, which takes a few
+        O(grid) solves instead of a full eigen solve.
+
+        Parameters
+        ----------
+        warm_start : bool
+            If false, every rho_max is solved from scratch.
+        */
+        solver.set_warm_start(warm_start);
+        scheduler.set_warm_start(warm_start);
+    }
+
+    void set_binary_output(bool binary_input)
+    {   /*
+        If true, the results are written to "eigendata_omega_<freq>.bin" by
+        an EigenWriter instead of to the text files, which is about 2.5 times
+        smaller and much faster for large grids. If not called, the text files
+        are written. Read the binary files with read_eigendata in
+        quantum_dots.py.
+
+        Parameters
+        ----------
+        binary_input : bool
+            Toggling binary output on/off.
+        */
+        binary = binary_input;
+        scheduler.set_binary_output(binary);
+    }
+
+    void set_parallel(bool parallel_input)
+    {   /*
+        If true, the eigendata_freq methods only queue their scans, and
+        run_scans computes all of them in parallel, see ScanScheduler. If not
+        called, every method computes its scan at once.
+
+        Parameters
+        ----------
+        parallel_input : bool
+            Toggling the queueing on/off.
+        */
+        parallel = parallel_input;
+        scheduler.set_progress(progress);
+        scheduler.set_rho_min(rho_min);
+    }
+
+    void run_scans()
+    {   /*
+        Computes the queued scans over all threads and MPI ranks, and appends
+        the results to the same files as the eigendata_freq methods would, in
+        the order the scans were queued.
+        */
+        scheduler.run();
+        scheduler.write();
+        scheduler.clear();
+    }
+
+    void set_grid(int grid_input)
+    {   /*
+        For setting the number of grid points. If not called, 200 is used.
+        Only the ground state is computed, with Lanczos for grid >= 200 by
+        the "auto" solver, O(grid) per rho_max, so grids of 10^5 points take
+        about as long as 200 points with Jacobi's method did.
+
+        Parameters
+        ----------
+        grid_input : int
+            Number of grid points.
+        */
+        grid = grid_input;
+    }
+
     void eigendata_freq_001()
     {
         /*
@@ -186,8 +289,7 @@ public:
         d_rho    = 0.1;    // rho step size for incrementing in the loop
         freq     = 0.01; 
         filename = "omega_" + std::to_string(freq);
-        compute_and_write_eigendata(freq, filename, progress, rho_min, rho_max,
-            grid, tol_off_diag, rho_end, d_rho);
+        scan();
     }
 
     void eigendata_freq_005()
@@ -203,8 +305,7 @@ public:
         d_rho    = 0.2;    // rho step size for incrementing in the loop
         freq     = 0.05; 
         filename = "omega_" + std::to_string(freq);
-        compute_and_write_eigendata(freq, filename, progress, rho_min, rho_max,
-            grid, tol_off_diag, rho_end, d_rho);
+        scan();
     }
 
     void eigendata_freq_025()
@@ -220,8 +321,7 @@ public:
         d_rho    = 0.2;    // rho step size for incrementing in the loop
         freq     = 0.25; 
         filename = "omega_" + std::to_string(freq);
-        compute_and_write_eigendata(freq, filename, progress, rho_min, rho_max,
-            grid, tol_off_diag, rho_end, d_rho);
+        scan();
     }
 
     void eigendata_freq_05()
@@ -237,8 +337,7 @@ public:
         d_rho    = 0.05;    // rho step size for incrementing in the loop
         freq     = 0.5; 
         filename = "omega_" + std::to_string(freq);
-        compute_and_write_eigendata(freq, filename, progress, rho_min, rho_max,
-            grid, tol_off_diag, rho_end, d_rho);
+        scan();
     }
 
     void eigendata_freq_1()
@@ -254,8 +353,7 @@ public:
         d_rho    = 0.025;    // rho step size for incrementing in the loop
         freq     = 1; 
         filename = "omega_" + std::to_string(freq);
-        compute_and_write_eigendata(freq, filename, progress, rho_min, rho_max,
-            grid, tol_off_diag, rho_end, d_rho);
+        scan();
     }
 
     void eigendata_freq_5()
@@ -271,8 +369,7 @@ public:
         d_rho    = 0.2;    // rho step size for incrementing in the loop
         freq     = 5; 
         filename = "omega_" + std::to_string(freq);
-        compute_and_write_eigendata(freq, filename, progress, rho_min, rho_max,
-            grid, tol_off_diag, rho_end, d_rho);
+        scan();
     }
 
 
@@ -283,14 +380,24 @@ public:
 
 int main()
 {    
+    #ifdef USE_MPI
+        MPI_Init(NULL, NULL);
+    #endif
 
     Eigendata q;
+    // q.set_grid(100000);
+    q.set_parallel(true);
     q.eigendata_freq_001();
-    // q.eigendata_freq_005();
-    // q.eigendata_freq_025();
-    // q.eigendata_freq_05();
-    // q.eigendata_freq_1();
-    // q.eigendata_freq_5();
+    q.eigendata_freq_005();
+    q.eigendata_freq_025();
+    q.eigendata_freq_05();
+    q.eigendata_freq_1();
+    q.eigendata_freq_5();
+    q.run_scans();
+
+    #ifdef USE_MPI
+        MPI_Finalize();
+    #endif
 
     return 0;
-}
\ No newline at end of file
+}
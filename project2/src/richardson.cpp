@@ -0,0 +1,111 @@
+#include "richardson.h"
+
+
+RichardsonExtrapolation::RichardsonExtrapolation(int power_input)
+{
+    power = power_input;
+}
+
+
+void RichardsonExtrapolation::add(double step, const arma::vec& values)
+{
+    /*
+    Adds a level, the quantities computed with a smaller step size than the
+    previous level, and the new row of the tableau.
+
+    Parameters
+    ----------
+    step : double
+        Step size h.
+
+    values : const arma::vec&
+        The quantities computed with step size h.
+    */
+
+    int i = steps.size();
+    steps.push_back(step);
+    table.push_back(std::vector<arma::vec>(i + 1));
+    table[i][0] = values;
+
+    for (int k = 1; k <= i; k++)
+    {   // eliminating the h^(k power) term
+        double factor = std::pow(steps[i - k]/steps[i], power) - 1;
+        table[i][k] = table[i][k - 1] + (table[i][k - 1] - table[i - 1][k - 1])/factor;
+    }
+}
+
+
+void RichardsonExtrapolation::clear()
+{
+    steps.clear();
+    table.clear();
+}
+
+
+int RichardsonExtrapolation::levels() const
+{
+    return steps.size();
+}
+
+
+arma::vec RichardsonExtrapolation::extrapolated() const
+{
+    /*
+    The best estimate of E(0), the last diagonal element of the tableau.
+    */
+    int m = steps.size() - 1;
+    return table[m][m];
+}
+
+
+arma::vec RichardsonExtrapolation::error_estimate() const
+{
+    /*
+    The absolute error estimate of extrapolated, the difference between the
+    last two elements of the last row of the tableau, i.e., the size of the
+    last term removed. Infinite with only one level.
+    */
+
+    int m = steps.size() - 1;
+    arma::vec error(table[m][0].n_elem);
+
+    if (m < 1)
+    {
+        error.fill(std::numeric_limits<double>::infinity());
+        return error;
+    }
+
+    for (int j = 0; j < (int) error.n_elem; j++)
+    {
+        error(j) = std::fabs(table[m][m](j) - table[m][m - 1](j));
+    }
+
+    return error;
+}
+
+
+bool RichardsonExtrapolation::converged(double tol) const
+{
+    /*
+    True if all error estimates are below tol relative to the extrapolated
+    values, and at least three levels have been added, so the estimate
+    is based on a difference of extrapolated values.
+
+    Parameters
+    ----------
+    tol : double
+        Relative tolerance.
+    */
+
+    if (steps.size() < 3) return false;
+
+    arma::vec error  = error_estimate();
+    arma::vec values = extrapolated();
+
+    for (int j = 0; j < (int) error.n_elem; j++)
+    {
+        if (error(j) > tol*std::fabs(values(j))) return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,50 @@
+#ifndef RICHARDSON_H
+#define RICHARDSON_H
+
+#include <armadillo>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+
+class RichardsonExtrapolation
+{
+    /*
+    Richardson extrapolation of a vector of quantities, e.g., eigenvalues,
+    computed with a sequence of step sizes h_0 > h_1 > ..., to h = 0. The
+    error is assumed to be a series in h^power,
+
+        E(h) = E(0) + c_1 h^power + c_2 h^(2 power) + ...,
+
+    and the Neville tableau
+
+        T(i, 0) = E(h_i)
+        T(i, k) = T(i, k-1) + (T(i, k-1) - T(i-1, k-1))/((h_(i-k)/h_i)^power - 1)
+
+    removes one more term per column. The grid in quantum_dots.cpp has its
+    inner boundary at rho_min - h, so the error has all powers of h and power
+    is 1. With a second order discretization with the boundaries on the grid,
+    power is 2. The step sizes need not be geometric, but halving h every
+    level keeps the tableau well conditioned.
+
+    Parameters
+    ----------
+    power : int
+        Power of h of the error series. Defaults to 1.
+    */
+private:
+    int power;
+    std::vector<double> steps;
+    std::vector<std::vector<arma::vec> > table;     // table[i][k] = T(i, k)
+
+public:
+    RichardsonExtrapolation(int power_input = 1);
+    void add(double step, const arma::vec& values);
+    void clear();
+    int levels() const;
+    arma::vec extrapolated() const;
+    arma::vec error_estimate() const;
+    bool converged(double tol) const;
+};
+
+#endif
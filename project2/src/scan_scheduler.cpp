@@ -0,0 +1,318 @@
+#include "scan_scheduler.h"
+
+
+ScanScheduler::ScanScheduler()
+{
+    #ifdef USE_MPI
+        // MPI_Init must have been called, see quantum_dots_two_electrons.cpp
+        MPI_Comm_rank(MPI_COMM_WORLD, &world_rank);
+        MPI_Comm_size(MPI_COMM_WORLD, &world_size);
+    #endif
+}
+
+
+void ScanScheduler::add_scan(double freq, double rho_max, double rho_end,
+    double d_rho, int grid, std::string filename)
+{
+    /*
+    Adds the points rho_max, rho_max + d_rho, ... up to and including rho_end,
+    the same values as the loop in compute_and_write_eigendata.
+
+    Parameters
+    ----------
+    freq : double
+        Oscillator frequency for the harmonic oscillator.
+
+    rho_max : double
+        Where the potential ends for the first point.
+
+    rho_end : double
+        Largest rho_max.
+
+    d_rho : double
+        Increment for rho_max.
+
+    grid : int
+        Number of grid points.
+
+    filename : std::string
+        The results are appended to "eigenvalue_" + filename + ".txt" and
+        "eigenvector_" + filename + ".txt", or "eigendata_" + filename + ".bin",
+        by write.
+    */
+
+    int scan = filenames.size();
+    filenames.push_back(filename);
+
+    while (rho_max <= rho_end)
+    {
+        points.push_back({freq, rho_max, grid, scan});
+        rho_max = rho_max + d_rho;
+    }
+}
+
+
+void ScanScheduler::set_rho_min(double rho_min_input)
+{
+    rho_min = rho_min_input;
+}
+
+
+void ScanScheduler::set_chunk(int chunk_input)
+{
+    /*
+    Largest number of points per task. Larger tasks do fewer cold solves,
+    smaller tasks balance the load better. Defaults to 16.
+    */
+    chunk = std::max(chunk_input, 1);
+}
+
+
+void ScanScheduler::set_solver(std::string name)
+{
+    /*
+    Backend for the cold solves, see make_eigen_solver. Defaults to "auto".
+    */
+    solver_name = name;
+}
+
+
+void ScanScheduler::set_warm_start(bool warm_start_input)
+{
+    warm_start = warm_start_input;
+}
+
+
+void ScanScheduler::set_progress(bool progress_input)
+{
+    progress = progress_input;
+}
+
+
+void ScanScheduler::set_binary_output(bool binary_input)
+{
+    /*
+    If true, write uses an EigenWriter per scan instead of the text files.
+    Defaults to false.
+    */
+    binary = binary_input;
+}
+
+
+void ScanScheduler::clear()
+{
+    /*
+    Removes all scans and results, e.g., after write.
+    */
+    points.clear();
+    filenames.clear();
+    eigenvalues.clear();
+    ground_states.clear();
+}
+
+
+int ScanScheduler::number_of_points() const
+{
+    return points.size();
+}
+
+
+const ScanPoint& ScanScheduler::point(int i) const
+{
+    return points[i];
+}
+
+
+double ScanScheduler::eigenvalue(int i) const
+{
+    return eigenvalues[i];
+}
+
+
+const arma::vec& ScanScheduler::ground_state(int i) const
+{
+    return ground_states[i];
+}
+
+
+std::vector<ScanTask> ScanScheduler::make_tasks() const
+{
+    /*
+    Splits every scan into tasks of at most 'chunk' points, sorted by
+    decreasing cost. Ties keep the order of the points, so the task list is
+    the same on every rank.
+    */
+
+    std::vector<ScanTask> tasks;
+    int num_points = points.size();
+    int first = 0;
+
+    while (first < num_points)
+    {
+        int count = 1;
+        while ((first + count < num_points) && (count < chunk)
+            && (points[first + count].scan == points[first].scan))
+        {
+            count++;
+        }
+
+        double cost = (double) points[first].grid*(count + 4);
+        tasks.push_back({first, count, cost});
+        first += count;
+    }
+
+    std::stable_sort(tasks.begin(), tasks.end(),
+        [](const ScanTask& a, const ScanTask& b) { return a.cost > b.cost; });
+
+    return tasks;
+}
+
+
+void ScanScheduler::run_task(const ScanTask& task)
+{
+    /*
+    Solves the points of one task in order, each starting from the ground
+    state of the previous one.
+    */
+
+    GroundStateContinuation solver(solver_name);
+    solver.set_warm_start(warm_start);
+
+    for (int i = task.first; i < task.first + task.count; i++)
+    {
+        const ScanPoint& p = points[i];
+        CoulombHamiltonian H(p.grid, rho_min, p.rho_max, p.freq);
+        eigenvalues[i] = solver.solve(H, ground_states[i]);
+    }
+
+    if (progress)
+    {   // for printing progress data
+        #pragma omp critical
+        {
+            std::cout << "rank " << world_rank << " freq: " << points[task.first].freq;
+            std::cout << " rho_max: " << points[task.first].rho_max << " - ";
+            std::cout << points[task.first + task.count - 1].rho_max;
+            std::cout << " n: " << points[task.first].grid << std::endl;
+        }
+    }
+}
+
+
+void ScanScheduler::run()
+{
+    /*
+    Solves all points, see the class description. With MPI, the results are
+    only complete on rank 0.
+    */
+
+    int num_points = points.size();
+    eigenvalues.assign(num_points, 0);
+    ground_states.assign(num_points, arma::vec());
+
+    std::vector<ScanTask> tasks = make_tasks();
+    int num_tasks = tasks.size();
+
+    // distributing the tasks over the ranks, largest first to the least loaded
+    std::vector<int> owner(num_tasks);
+    std::vector<double> load(world_size, 0);
+    for (int t = 0; t < num_tasks; t++)
+    {
+        int rank = std::min_element(load.begin(), load.end()) - load.begin();
+        owner[t] = rank;
+        load[rank] += tasks[t].cost;
+    }
+
+    std::vector<ScanTask> my_tasks;
+    for (int t = 0; t < num_tasks; t++)
+    {
+        if (owner[t] == world_rank) my_tasks.push_back(tasks[t]);
+    }
+    int num_my_tasks = my_tasks.size();
+
+    #pragma omp parallel for schedule(dynamic, 1)
+    for (int t = 0; t < num_my_tasks; t++)
+    {   // the threads take the most expensive remaining task
+        run_task(my_tasks[t]);
+    }
+
+    #ifdef USE_MPI
+        for (int t = 0; t < num_tasks; t++)
+        {   // sending the results to rank 0, in task order
+            if ((owner[t] == 0) || ((world_rank != 0) && (world_rank != owner[t])))
+            {
+                continue;
+            }
+
+            const ScanTask& task = tasks[t];
+            int grid = points[task.first].grid;
+            std::vector<double> buffer(task.count*(grid + 1));
+
+            if (world_rank == owner[t])
+            {
+                for (int i = 0; i < task.count; i++)
+                {
+                    buffer[i*(grid + 1)] = eigenvalues[task.first + i];
+                    std::copy(ground_states[task.first + i].begin(),
+                        ground_states[task.first + i].end(),
+                        buffer.begin() + i*(grid + 1) + 1);
+                }
+                MPI_Send(buffer.data(), buffer.size(), MPI_DOUBLE, 0, t, MPI_COMM_WORLD);
+            }
+            else
+            {
+                MPI_Recv(buffer.data(), buffer.size(), MPI_DOUBLE, owner[t], t,
+                    MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+                for (int i = 0; i < task.count; i++)
+                {
+                    eigenvalues[task.first + i] = buffer[i*(grid + 1)];
+                    ground_states[task.first + i] = arma::vec(&buffer[i*(grid + 1) + 1], grid);
+                }
+            }
+        }
+    #endif
+}
+
+
+void ScanScheduler::write() const
+{
+    /*
+    Appends the results of every scan to its files, in the order the scans
+    were added. Only rank 0 writes.
+    */
+
+    if (world_rank != 0) return;
+
+    int num_points = points.size();
+    int i = 0;
+
+    for (int scan = 0; scan < (int) filenames.size(); scan++)
+    {
+        if (binary)
+        {
+            EigenWriter writer("eigendata_" + filenames[scan] + ".bin");
+            for (; (i < num_points) && (points[i].scan == scan); i++)
+            {
+                writer.write(points[i].rho_max, eigenvalues[i], ground_states[i]);
+            }
+            continue;
+        }
+
+        std::ofstream data_file_eig("eigenvalue_" + filenames[scan] + ".txt", std::ios_base::app);
+        std::ofstream data_file_vec("eigenvector_" + filenames[scan] + ".txt", std::ios_base::app);
+
+        data_file_eig << std::setw(6) << "rho" << std::setw(20) << "eigenvalue" << std::endl;
+        data_file_vec << std::setw(20) << "rho | eigenvector ->" << std::endl;
+
+        for (; (i < num_points) && (points[i].scan == scan); i++)
+        {
+            data_file_eig << std::setw(6) << points[i].rho_max << std::setw(20) << std::setprecision(10) << eigenvalues[i] << '\n';
+            data_file_vec << std::setw(20) << points[i].rho_max;
+
+            for (int j = 0; j < points[i].grid; j++)
+            {   // writing eigenvector to file
+                data_file_vec << std::setw(20) << std::setprecision(10) << ground_states[i](j);
+            }
+            data_file_vec << '\n';
+        }
+    }
+}
@@ -0,0 +1,105 @@
+#ifndef SCAN_SCHEDULER_H
+#define SCAN_SCHEDULER_H
+
+#include <armadillo>
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "eigen_solver.h"
+#include "eigen_writer.h"
+
+#ifdef _OPENMP
+    #include <omp.h>
+#endif
+
+#ifdef USE_MPI
+    #include <mpi.h>
+#endif
+
+
+struct ScanPoint
+{
+    /*
+    One ground state solve of the two electron Hamiltonian.
+    */
+    double freq;
+    double rho_max;
+    int grid;
+    int scan;           // index of the scan the point belongs to
+};
+
+
+struct ScanTask
+{
+    /*
+    A run of consecutive points of one scan, which are solved in order by the
+    same GroundStateContinuation.
+    */
+    int first;          // index of the first point
+    int count;          // number of points
+    double cost;        // estimated runtime in arbitrary units
+};
+
+
+class ScanScheduler
+{
+    /*
+    Runs many rho_max scans, e.g., for all the frequencies in
+    quantum_dots_two_electrons.cpp, in parallel. add_scan expands a scan into
+    its (freq, rho_max, grid) points, and run splits the points into tasks of
+    at most 'chunk' consecutive rho_max values, so the warm start of
+    GroundStateContinuation is kept within a task.
+
+    The solvers are O(grid) per point, so a task costs about grid*(count + 4),
+    where the 4 is the cold solve of the first point. The tasks are sorted by
+    decreasing cost. OpenMP threads take the next task when done with the
+    previous one, so the large grids are started first and the small ones fill
+    in at the end. Compiled with -DUSE_MPI, the tasks are first distributed
+    over the MPI ranks, each to the rank with the smallest total cost so far,
+    and the results are sent to rank 0.
+
+    The results do not depend on the number of threads or ranks, and write
+    writes them in the order the scans were added, in the same format as
+    compute_and_write_eigendata, text or binary.
+    */
+private:
+    std::vector<ScanPoint> points;
+    std::vector<std::string> filenames;     // one per scan
+    std::vector<double> eigenvalues;        // one per point
+    std::vector<arma::vec> ground_states;   // one per point
+    double rho_min = 1e-7;
+    int chunk = 16;                         // largest number of points per task
+    bool warm_start = true;
+    bool progress = true;
+    bool binary = false;                    // EigenWriter instead of text files
+    std::string solver_name = "auto";
+    int world_rank = 0;
+    int world_size = 1;
+
+    void run_task(const ScanTask& task);
+
+public:
+    ScanScheduler();
+    void add_scan(double freq, double rho_max, double rho_end, double d_rho,
+        int grid, std::string filename);
+    void set_rho_min(double rho_min_input);
+    void set_chunk(int chunk_input);
+    void set_solver(std::string name);
+    void set_warm_start(bool warm_start_input);
+    void set_progress(bool progress_input);
+    void set_binary_output(bool binary_input);
+    std::vector<ScanTask> make_tasks() const;
+    void run();
+    void write() const;
+    void clear();
+
+    int number_of_points() const;
+    const ScanPoint& point(int i) const;
+    double eigenvalue(int i) const;
+    const arma::vec& ground_state(int i) const;
+};
+
+#endif
@@ -0,0 +1,177 @@
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+#include "banded_hamiltonian.h"
+
+
+static double max_relative_error(const arma::vec& eigenvalues)
+{
+    /*
+    The largest relative error of the harmonic oscillator eigenvalues, whose
+    exact values are 3, 7, 11, ...
+    */
+
+    double error = 0;
+    for (int k = 0; k < (int) eigenvalues.n_elem; k++)
+    {
+        double exact = 3 + 4*k;
+        error = std::max(error, std::fabs(eigenvalues(k) - exact)/exact);
+    }
+    return error;
+}
+
+
+static double band_element(const arma::mat& band, int bandwidth, int i, int j)
+{
+    /*
+    Element (i, j) of a symmetric matrix in the band storage of
+    stencil_hamiltonian.
+    */
+
+    if (i > j) std::swap(i, j);
+    return (j - i <= bandwidth) ? band(bandwidth + i - j, j) : 0.0;
+}
+
+
+TEST_CASE("test_stencil_hamiltonian_order_2")
+{
+    /*
+    Checks that banded_eig of the 3-point stencil gives the same eigenvalues
+    as the tridiagonal lapack EigenSolver.
+    */
+
+    int n = 200;
+    int num_eig = 6;
+    double step = 8.0/(n + 1);
+
+    arma::vec V(n);
+    for (int i = 0; i < n; i++) V(i) = ((i + 1)*step)*((i + 1)*step);
+
+    arma::mat band = stencil_hamiltonian(n, step, V, 2);
+    REQUIRE(stencil_bandwidth(2) == 1);
+    REQUIRE(band.n_rows == 2);
+
+    arma::vec diag(n);
+    arma::vec off_diag(n - 1);
+    for (int i = 0; i < n; i++)
+    {
+        diag(i) = band(1, i);
+        if (i > 0) off_diag(i - 1) = band(0, i);
+    }
+
+    arma::vec expected = make_eigen_solver("lapack")->solve(n, diag, off_diag, num_eig);
+    arma::vec computed = banded_eig(n, 1, band, num_eig);
+
+    for (int k = 0; k < num_eig; k++)
+    {
+        REQUIRE(fabs(computed(k) - expected(k)) < 1e-10*expected(k));
+    }
+}
+
+TEST_CASE("test_stencil_convergence_order")
+{
+    /*
+    Checks the order of every method on the harmonic oscillator: halving the
+    step size, h = 8/(n + 1), should reduce the error by about 2^order, i.e.,
+    4 for the 3-point stencil, 16 for the 5-point stencil and Numerov, and 64
+    for the 7-point stencil.
+    */
+
+    struct Case { std::string method; int n; double ratio; };
+    Case cases[4] = {{"3-point", 99, 4}, {"5-point", 99, 16},
+        {"7-point", 49, 64}, {"numerov", 99, 16}};
+
+    for (Case c : cases)
+    {
+        auto V = [](double rho) { return rho*rho; };
+        double coarse = max_relative_error(radial_eigenvalues(c.method, c.n, 8, V, 4));
+        double fine   = max_relative_error(radial_eigenvalues(c.method, 2*c.n + 1, 8, V, 4));
+
+        INFO(c.method << ": " << coarse << " -> " << fine);
+        REQUIRE(coarse/fine > 0.8*c.ratio);
+        REQUIRE(coarse/fine < 1.2*c.ratio);
+    }
+
+    // 4 digits with 50 points for the 7-point stencil
+    REQUIRE(max_relative_error(radial_eigenvalues("7-point", 50, 8,
+        [](double rho) { return rho*rho; }, 4)) < 1e-4);
+}
+
+TEST_CASE("test_banded_eigenvectors")
+{
+    /*
+    Checks that the eigenvectors of banded_eig and banded_generalized_eig are
+    normalized, have small residuals and the largest component positive.
+    */
+
+    int n = 300;
+    int num_eig = 5;
+    double step = 8.0/(n + 1);
+
+    arma::vec V(n);
+    for (int i = 0; i < n; i++) V(i) = ((i + 1)*step)*((i + 1)*step);
+
+    SECTION("7-point")
+    {
+        int b = stencil_bandwidth(6);
+        arma::mat band = stencil_hamiltonian(n, step, V, 6);
+        arma::mat R;
+        arma::vec eigenvalues = banded_eig(n, b, band, num_eig, &R);
+
+        for (int k = 0; k < num_eig; k++)
+        {
+            double norm = 0;
+            double residual = 0;
+            for (int i = 0; i < n; i++)
+            {   // (H - lambda) u
+                double r = -eigenvalues(k)*R(i, k);
+                for (int j = std::max(0, i - b); j <= std::min(n - 1, i + b); j++)
+                {
+                    r += band_element(band, b, i, j)*R(j, k);
+                }
+                residual += r*r;
+                norm += R(i, k)*R(i, k);
+            }
+            REQUIRE(fabs(norm - 1) < 1e-10);
+            REQUIRE(std::sqrt(residual) < 1e-8*(4/(step*step)));
+        }
+    }
+
+    SECTION("numerov")
+    {
+        arma::mat A;
+        arma::mat M;
+        numerov_hamiltonian(n, step, V, A, M);
+        arma::mat W;
+        arma::vec eigenvalues = banded_generalized_eig(n, 2, A, M, num_eig, &W);
+
+        arma::mat U;
+        arma::vec radial = radial_eigenvalues("numerov", n, 8,
+            [](double rho) { return rho*rho; }, num_eig, &U);
+
+        for (int k = 0; k < num_eig; k++)
+        {
+            REQUIRE(fabs(radial(k) - eigenvalues(k)) < 1e-12*eigenvalues(k));
+
+            double w_norm = 0;
+            double u_norm = 0;
+            double residual = 0;
+            int largest = 0;
+            for (int i = 0; i < n; i++)
+            {   // (A - lambda M) w, and the normalization w^T M w
+                double r = 0;
+                for (int j = std::max(0, i - 2); j <= std::min(n - 1, i + 2); j++)
+                {
+                    r += (band_element(A, 2, i, j) - eigenvalues(k)*band_element(M, 2, i, j))*W(j, k);
+                    w_norm += W(i, k)*band_element(M, 2, i, j)*W(j, k);
+                }
+                residual += r*r;
+                u_norm += U(i, k)*U(i, k);
+                if (fabs(U(i, k)) > fabs(U(largest, k))) largest = i;
+            }
+            REQUIRE(fabs(w_norm - 1) < 1e-10);
+            REQUIRE(fabs(u_norm - 1) < 1e-10);
+            REQUIRE(std::sqrt(residual) < 1e-8*(4/(step*step)));
+            REQUIRE(U(largest, k) > 0);
+        }
+    }
+}
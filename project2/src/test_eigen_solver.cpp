@@ -0,0 +1,240 @@
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+#include "eigen_solver.h"
+
+
+TEST_CASE("test_eigen_solver_backends")
+{
+    /*
+    Checks that all backends find the analytical lowest eigenvalues of the
+    (off_diag, diag, off_diag) Toeplitz matrix, and eigenvectors with a small
+    residual |T r - lambda r|.
+    */
+
+    int n = 100;                                // dimension of matrix
+    int num_eig = 5;                            // number of eigenpairs
+    double step     = 1.0/n;
+    double diag     = 2/(step*step);            // diagonal elements
+    double off_diag = -1/(step*step);           // off-diagonal elements
+    double tol      = std::pow(10, -8);         // relative tolerance
+
+    arma::vec diag_elements(n);
+    arma::vec off_diag_elements(n - 1);
+    diag_elements.fill(diag);
+    off_diag_elements.fill(off_diag);
+
+    for (std::string name : {"jacobi", "ql", "lapack", "lanczos", "auto"})
+    {
+        std::unique_ptr<EigenSolver> solver = make_eigen_solver(name);
+        arma::mat R;
+        arma::vec eigenvalues = solver->solve(n, diag_elements, off_diag_elements,
+            num_eig, &R);
+
+        REQUIRE(eigenvalues.n_elem == num_eig);
+        REQUIRE(R.n_rows == n);
+        REQUIRE(R.n_cols == num_eig);
+
+        for (int j = 0; j < num_eig; j++)
+        {
+            double exact = diag + 2*off_diag*std::cos((j + 1)*pi/(n + 1));
+            REQUIRE(fabs(exact - eigenvalues(j))/fabs(diag) < tol);
+
+            double residual = 0;
+            double norm = 0;
+            for (int i = 0; i < n; i++)
+            {   // (T r)_i - lambda r_i
+                double t_r = diag*R(i, j);
+                if (i > 0)     t_r += off_diag*R(i - 1, j);
+                if (i < n - 1) t_r += off_diag*R(i + 1, j);
+                residual = std::max(residual, fabs(t_r - eigenvalues(j)*R(i, j)));
+                norm += R(i, j)*R(i, j);
+            }
+            REQUIRE(residual/fabs(diag) < tol);
+            REQUIRE(fabs(norm - 1) < tol);
+        }
+
+        // eigenvalues only
+        arma::vec eigenvalues_only = solver->solve(n, diag_elements, off_diag_elements,
+            num_eig);
+        for (int j = 0; j < num_eig; j++)
+        {
+            REQUIRE(fabs(eigenvalues_only(j) - eigenvalues(j))/fabs(diag) < tol);
+        }
+    }
+}
+
+TEST_CASE("test_lanczos_large_grid")
+{
+    /*
+    Checks that Lanczos agrees with dstevr for the lowest eigenpairs of the
+    harmonic oscillator on a fine grid, where the largest eigenvalue is 10^8
+    times the smallest.
+    */
+
+    int n = 20000;                              // dimension of matrix
+    int num_eig = 3;                            // number of eigenpairs
+    double step     = 5.0/(n + 1);
+    double off_diag = -1/(step*step);
+    double tol      = std::pow(10, -6);
+
+    arma::vec diag_elements(n);
+    arma::vec off_diag_elements(n - 1);
+    off_diag_elements.fill(off_diag);
+    for (int i = 0; i < n; i++)
+    {   // harmonic oscillator potential
+        diag_elements(i) = 2/(step*step) + ((i + 1)*step)*((i + 1)*step);
+    }
+
+    arma::mat R_lanczos;
+    arma::mat R_lapack;
+    arma::vec eig_lanczos = make_eigen_solver("lanczos")->solve(n, diag_elements,
+        off_diag_elements, num_eig, &R_lanczos);
+    arma::vec eig_lapack = make_eigen_solver("lapack")->solve(n, diag_elements,
+        off_diag_elements, num_eig, &R_lapack);
+
+    for (int j = 0; j < num_eig; j++)
+    {   // 3, 7, 11 for the continuous problem, up to the cut-off at rho = 5
+        REQUIRE(fabs(eig_lanczos(j) - eig_lapack(j)) < tol);
+        REQUIRE(fabs(eig_lanczos(j) - (3 + 4*j)) < 1e-3);
+
+        arma::vec r_lanczos = R_lanczos.col(j);
+        arma::vec r_lapack  = R_lapack.col(j);
+        REQUIRE(fabs(fabs(arma::dot(r_lanczos, r_lapack)) - 1) < tol);
+    }
+}
+
+TEST_CASE("test_lanczos_breakdown")
+{
+    /*
+    Checks that Lanczos restarts when the Krylov subspace is invariant before
+    num_eig vectors. Two equal decoupled blocks tridiag(-1, 2, -1) of size 3
+    have the eigenvalues 2 - sqrt(2), 2 and 2 + sqrt(2), all twice, so the
+    Krylov subspace of any start vector has dimension 3 < num_eig = 4 < n.
+    */
+
+    int n = 6;                                  // dimension of matrix
+    int num_eig = 4;                            // number of eigenpairs
+    double tol = std::pow(10, -10);
+
+    arma::vec diag_elements(n);
+    arma::vec off_diag_elements(n - 1);
+    diag_elements.fill(2);
+    off_diag_elements.fill(-1);
+    off_diag_elements(2) = 0;
+
+    arma::mat R;
+    arma::vec eigenvalues = make_eigen_solver("lanczos")->solve(n, diag_elements,
+        off_diag_elements, num_eig, &R);
+
+    double exact[4] = {2 - std::sqrt(2), 2 - std::sqrt(2), 2, 2};
+    arma::mat A = construct_diag_matrix(n, -1, diag_elements);
+    A(2, 3) = A(3, 2) = 0;
+
+    for (int j = 0; j < num_eig; j++)
+    {
+        REQUIRE(fabs(eigenvalues(j) - exact[j]) < tol);
+        REQUIRE(arma::norm(A*R.col(j) - eigenvalues(j)*R.col(j)) < tol);
+        for (int k = 0; k <= j; k++)
+        {   // orthonormal, also within the degenerate pairs
+            double expected = (k == j) ? 1 : 0;
+            REQUIRE(fabs(arma::dot(R.col(j), R.col(k)) - expected) < tol);
+        }
+    }
+}
+
+TEST_CASE("test_lanczos_not_converged")
+{
+    /*
+    Checks that Lanczos throws instead of returning unconverged Ritz pairs
+    when max_iterations is reached before tol, and converges for the same
+    matrix with the default max_iterations.
+    */
+
+    int n = 100;                                // dimension of matrix
+    int num_eig = 3;                            // number of eigenpairs
+
+    arma::vec diag_elements(n);
+    arma::vec off_diag_elements(n - 1);
+    diag_elements.fill(2);
+    off_diag_elements.fill(-1);
+
+    LanczosEigenSolver few_iterations(1e-12, 4);
+    REQUIRE_THROWS_AS(few_iterations.solve(n, diag_elements, off_diag_elements,
+        num_eig), std::runtime_error);
+
+    LanczosEigenSolver default_iterations;
+    REQUIRE_NOTHROW(default_iterations.solve(n, diag_elements, off_diag_elements,
+        num_eig));
+}
+
+TEST_CASE("test_eigen_solver_names")
+{
+    /*
+    Checks that make_eigen_solver makes the requested backend, and throws for
+    an unknown name.
+    */
+
+    for (std::string name : {"jacobi", "ql", "lapack", "lanczos", "auto"})
+    {
+        REQUIRE(make_eigen_solver(name)->name() == name);
+    }
+
+    REQUIRE_THROWS(make_eigen_solver("power"));
+}
+
+TEST_CASE("test_ground_state_continuation")
+{
+    /*
+    Checks that the warm-started ground states of a rho_max scan of the two
+    electron Hamiltonian agree with dstevr, and that only the first rho_max
+    needs a cold solve.
+    */
+
+    int grid = 400;                             // number of grid points
+    double rho_min = 1e-7;
+    double freq    = 0.25;
+    double tol     = std::pow(10, -8);
+
+    GroundStateContinuation continuation("lapack");
+    std::unique_ptr<EigenSolver> lapack = make_eigen_solver("lapack");
+
+    for (double rho_max = 6; rho_max <= 10; rho_max += 0.2)
+    {
+        double step = (rho_max - rho_min)/grid;
+        arma::vec diag_elements(grid);
+        arma::vec off_diag_elements(grid - 1);
+        off_diag_elements.fill(-1/(step*step));
+        for (int i = 0; i < grid; i++)
+        {   // harmonic oscillator and Coulomb potential
+            double rho = rho_min + i*step;
+            diag_elements(i) = 2/(step*step) + freq*freq*rho*rho + 1/rho;
+        }
+
+        arma::vec ground_state;
+        double eigenvalue = continuation.solve(grid, diag_elements,
+            off_diag_elements, rho_min, step, ground_state);
+
+        arma::mat R;
+        arma::vec eigenvalues = lapack->solve(grid, diag_elements,
+            off_diag_elements, 1, &R);
+        arma::vec r = R.col(0);
+
+        REQUIRE(fabs(eigenvalue - eigenvalues(0)) < tol);
+        REQUIRE(fabs(arma::dot(ground_state, r) - 1) < tol);
+    }
+
+    REQUIRE(continuation.number_of_cold_solves() == 1);
+    REQUIRE(continuation.number_of_warm_solves() == 20);
+
+    // without the continuation every solve is cold
+    continuation.reset();
+    continuation.set_warm_start(false);
+    arma::vec diag_elements(grid);
+    arma::vec off_diag_elements(grid - 1);
+    diag_elements.fill(2);
+    off_diag_elements.fill(-1);
+    arma::vec ground_state;
+    continuation.solve(grid, diag_elements, off_diag_elements, 0, 1, ground_state);
+    continuation.solve(grid, diag_elements, off_diag_elements, 0, 1, ground_state);
+    REQUIRE(continuation.number_of_cold_solves() == 3);
+}
@@ -0,0 +1,111 @@
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+#include "eigen_writer.h"
+#include <cstdio>
+
+
+TEST_CASE("test_eigen_writer")
+{
+    /*
+    Writes records of different lengths with a buffer smaller than a record,
+    with and without the writer thread, and in two sessions, and checks that
+    the file holds one header and all records, bit for bit.
+    */
+
+    for (bool background : {false, true})
+    {
+        std::string filename = "test_eigen_writer.bin";
+        std::remove(filename.c_str());
+
+        int num_records = 50;
+        std::vector<arma::vec> vectors(num_records);
+        for (int r = 0; r < num_records; r++)
+        {
+            vectors[r].set_size(10 + 7*r);
+            for (int j = 0; j < (int) vectors[r].n_elem; j++)
+            {
+                vectors[r](j) = std::sin(1.0 + r + 0.1*j);
+            }
+        }
+
+        for (int session = 0; session < 2; session++)
+        {   // the second session appends to the first
+            EigenWriter writer(filename, 1000, background);
+            for (int r = session*num_records/2; r < (session + 1)*num_records/2; r++)
+            {
+                writer.write(0.5 + r, -1.0/(r + 1), vectors[r]);
+            }
+        }
+
+        std::ifstream file(filename, std::ios_base::binary);
+        char magic[8];
+        file.read(magic, 8);
+        REQUIRE(std::string(magic, 8) == "QDEIGV01");
+
+        for (int r = 0; r < num_records; r++)
+        {
+            std::int64_t n;
+            double rho_max;
+            double eigenvalue;
+            file.read((char*) &n, 8);
+            file.read((char*) &rho_max, 8);
+            file.read((char*) &eigenvalue, 8);
+            REQUIRE(n == (std::int64_t) vectors[r].n_elem);
+            REQUIRE(rho_max == 0.5 + r);
+            REQUIRE(eigenvalue == -1.0/(r + 1));
+
+            std::vector<double> x(n);
+            file.read((char*) x.data(), 8*n);
+            for (int j = 0; j < n; j++)
+            {
+                REQUIRE(x[j] == vectors[r](j));
+            }
+        }
+
+        file.peek();
+        REQUIRE(file.eof());
+        file.close();
+        std::remove(filename.c_str());
+    }
+}
+
+TEST_CASE("test_eigen_writer_write_error")
+{
+    /*
+    Writes to /dev/full, where every write fails with no space left on the
+    device, and checks that flush throws, with and without the writer
+    thread, and that a failure on the writer thread is thrown by the next
+    write.
+    */
+
+    #ifdef __linux__
+    arma::vec x(100);
+    x.fill(1);
+
+    for (bool background : {false, true})
+    {
+        EigenWriter writer("/dev/full", 1000, background);
+        writer.write(1, -1, x);
+        REQUIRE_THROWS_AS(writer.flush(), std::runtime_error);
+        REQUIRE_THROWS_AS(writer.write(1, -1, x), std::runtime_error);
+        REQUIRE_THROWS_AS(writer.close(), std::runtime_error);
+    }
+
+    {   // the failed hand off to the writer thread is seen by a later write
+        EigenWriter writer("/dev/full", 1000, true);
+        bool thrown = false;
+        for (int r = 0; (r < 1000) && !thrown; r++)
+        {
+            try
+            {
+                writer.write(1, -1, x);
+            }
+            catch (const std::runtime_error&)
+            {
+                thrown = true;
+            }
+        }
+        REQUIRE(thrown);
+    }
+    #endif
+}
@@ -0,0 +1,182 @@
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+#include "hamiltonian_operator.h"
+#include "eigen_solver.h"
+#include "banded_hamiltonian.h"
+
+
+class SquaredLaplacian : public HamiltonianOperator
+{
+    /*
+    T^2 with T = tridiag(-1, 2, -1), a pentadiagonal operator with the
+    eigenvalues (2 - 2 cos(k pi/(n + 1)))^2, k = 1, ..., n.
+    */
+private:
+    int n;
+
+    void apply_T(const arma::vec& x, arma::vec& y) const
+    {
+        for (int i = 0; i < n; i++)
+        {
+            y(i) = 2*x(i);
+            if (i > 0)     y(i) -= x(i - 1);
+            if (i < n - 1) y(i) -= x(i + 1);
+        }
+    }
+
+public:
+    SquaredLaplacian(int n_input) { n = n_input; }
+
+    int size() const override { return n; }
+    int bandwidth() const override { return 2; }
+
+    void apply(const arma::vec& x, arma::vec& y) const override
+    {
+        arma::vec z(n);
+        y.set_size(n);
+        apply_T(x, z);
+        apply_T(z, y);
+    }
+
+    arma::vec diagonal() const override
+    {
+        arma::vec diag(n);
+        diag.fill(6);
+        diag(0)     = 5;
+        diag(n - 1) = 5;
+        return diag;
+    }
+
+    arma::vec off_diagonal(int k = 1) const override
+    {
+        arma::vec off_diag(n - k);
+        off_diag.fill((k == 1) ? -4 : 1);
+        return off_diag;
+    }
+};
+
+
+TEST_CASE("test_radial_hamiltonian_diagonals")
+{
+    /*
+    Checks that the diagonals of the operators are those of the drivers, that
+    apply agrees with the dense matrix, and that band is the upper triangle
+    of dense.
+    */
+
+    int n = 50;
+    double rho_min = 1e-7;
+    double rho_max = 5;
+    double freq    = 0.25;
+
+    HarmonicOscillatorHamiltonian oscillator(n, rho_min, rho_max);
+    CoulombHamiltonian coulomb(n, rho_min, rho_max, freq);
+
+    double step = (rho_max - rho_min)/n;
+    REQUIRE(oscillator.step_size() == step);
+    REQUIRE(oscillator.bandwidth() == 1);
+    REQUIRE(oscillator.size() == n);
+
+    arma::vec oscillator_diag = oscillator.diagonal();
+    arma::vec diag = coulomb.diagonal();
+
+    for (int i = 0; i < n; i++)
+    {
+        double rho = rho_min + i*step;
+        double coulomb_diag = 2/(step*step) + freq*freq*rho*rho + 1/rho;
+        REQUIRE(oscillator_diag(i) == 2/(step*step) + rho*rho);
+        REQUIRE(fabs(diag(i) - coulomb_diag) < 1e-14*coulomb_diag);
+        if (i < n - 1) REQUIRE(coulomb.off_diagonal(1)(i) == -1/(step*step));
+    }
+    REQUIRE_THROWS_AS(coulomb.off_diagonal(2), std::out_of_range);
+
+    arma::vec x(n);
+    for (int i = 0; i < n; i++) x(i) = std::sin(0.3*i) + 0.1*i;
+
+    for (const HamiltonianOperator* H : {(const HamiltonianOperator*) &coulomb,
+        (const HamiltonianOperator*) &oscillator})
+    {
+        arma::mat A = H->dense();
+        arma::mat band = H->band();
+        arma::vec y;
+        H->apply(x, y);
+
+        for (int i = 0; i < n; i++)
+        {
+            double expected = 0;
+            for (int j = 0; j < n; j++)
+            {
+                expected += A(i, j)*x(j);
+                if ((j >= i) && (j - i <= 1)) REQUIRE(band(1 + i - j, j) == A(i, j));
+            }
+            REQUIRE(fabs(y(i) - expected) < 1e-12*A(0, 0));
+        }
+    }
+}
+
+TEST_CASE("test_eigen_solver_operator")
+{
+    /*
+    Checks that every backend gives the same eigenpairs for an operator as
+    for its diagonals, that a wider operator is rejected, and that banded_eig
+    of the squared Laplacian finds its analytical eigenvalues.
+    */
+
+    int n = 80;
+    int num_eig = 4;
+    HarmonicOscillatorHamiltonian H(n, 1e-7, 6);
+
+    for (std::string name : {"jacobi", "ql", "lapack", "lanczos", "auto"})
+    {
+        std::unique_ptr<EigenSolver> solver = make_eigen_solver(name);
+        arma::mat R;
+        arma::vec eigenvalues = solver->solve(H, num_eig, &R);
+        arma::vec expected = solver->solve(n, H.diagonal(), H.off_diagonal(), num_eig);
+
+        for (int k = 0; k < num_eig; k++)
+        {
+            REQUIRE(eigenvalues(k) == expected(k));
+            REQUIRE(H.residual(eigenvalues(k), R.col(k)) < 1e-8*H.diagonal()(0));
+        }
+    }
+
+    SquaredLaplacian T2(n);
+    REQUIRE_THROWS_AS(make_eigen_solver("lapack")->solve(T2, num_eig), std::invalid_argument);
+
+    arma::mat R;
+    arma::vec eigenvalues = banded_eig(T2, num_eig, &R);
+
+    for (int k = 0; k < num_eig; k++)
+    {
+        double exact = std::pow(2 - 2*std::cos((k + 1)*pi/(n + 1)), 2);
+        REQUIRE(fabs(eigenvalues(k) - exact) < 1e-12);
+        REQUIRE(T2.residual(eigenvalues(k), R.col(k)) < 1e-10);
+    }
+}
+
+TEST_CASE("test_operator_million_points")
+{
+    /*
+    Checks that the two electron ground state is found on 10^6 grid points,
+    first by the "auto" EigenSolver and then by the warm start of
+    GroundStateContinuation, without any n x n matrix.
+    */
+
+    int n = 1000000;
+    double rho_min = 1e-7;
+    GroundStateContinuation solver;
+    arma::vec ground_state;
+
+    for (double rho_max : {8.0, 8.1})
+    {
+        CoulombHamiltonian H(n, rho_min, rho_max, 0.25);
+        double eigenvalue = solver.solve(H, ground_state);
+
+        REQUIRE(ground_state.n_elem == n);
+        REQUIRE(fabs(eigenvalue - 1.25) < 1e-4);
+        REQUIRE(H.residual(eigenvalue, ground_state) < 1e-6*H.diagonal()(0));
+    }
+
+    REQUIRE(solver.number_of_cold_solves() == 1);
+    REQUIRE(solver.number_of_warm_solves() == 1);
+}
@@ -152,3 +152,187 @@ TEST_CASE("test_find_eig")
         REQUIRE(fabs(eigenvalues(i) - sorted_diag(i)) < tol_eig);
     }
 }
+
+
+TEST_CASE("test_off_diagonal_max")
+{
+    /*
+    Checks that OffDiagonalMax finds the same element as find_max, both
+    initially and after each rotation done by transform.
+    */
+
+    int n = 30;                 // dimension of matrix
+    int rotations = 200;
+    
+    arma::mat A(n, n);
+    arma::mat R(n, n);
+    R.zeros();
+    R.diag(0) += 1;
+
+    for (int i = 0; i < n; i++)
+    {   // populating a symmetric matrix with arbitrary values
+        for (int j = 0; j <= i; j++)
+        {
+            A(i, j) = A(j, i) = std::sin(1.0 + 3*i + 7*j*j);
+        }
+    }
+
+    OffDiagonalMax tracker(n, A);
+
+    for (int r = 0; r < rotations; r++)
+    {
+        int idx_row;
+        int idx_col;
+        int idx_row_tracker;
+        int idx_col_tracker;
+        double max_val = find_max(n, A, idx_row, idx_col);
+        double max_val_tracker = tracker.find_max(idx_row_tracker, idx_col_tracker);
+
+        REQUIRE(max_val == max_val_tracker);
+        REQUIRE(idx_row == idx_row_tracker);
+        REQUIRE(idx_col == idx_col_tracker);
+
+        transform(n, A, R, idx_row, idx_col);
+        tracker.update(idx_row, idx_col);
+    }
+}
+
+
+TEST_CASE("test_find_eig_matches_brute_force")
+{
+    /*
+    Checks that find_eig does exactly the same rotations as
+    find_eig_brute_force, i.e., that the results are identical.
+    */
+
+    int n = 20;                                 // dimension of matrix
+    double step     = 5.0/n;
+    double off_diag = -1/(step*step);           // off-diagonal elements
+    double tol_off_diag = std::pow(10, -10);    // tolerance of off-diagonal elements
+    
+    arma::vec diag(n);
+    for (int i = 0; i < n; i++)
+    {   // harmonic oscillator potential
+        diag(i) = 2/(step*step) + ((i + 1)*step)*((i + 1)*step);
+    }
+
+    arma::mat A = construct_diag_matrix(n, off_diag, diag);
+    arma::mat A_brute_force = construct_diag_matrix(n, off_diag, diag);
+
+    arma::mat R = find_eig(n, A, tol_off_diag);
+    arma::mat R_brute_force = find_eig_brute_force(n, A_brute_force, tol_off_diag);
+
+    for (int i = 0; i < n; i++)
+    {
+        for (int j = 0; j < n; j++)
+        {
+            REQUIRE(A(i, j) == A_brute_force(i, j));
+            REQUIRE(R(i, j) == R_brute_force(i, j));
+        }
+    }
+}
+
+
+TEST_CASE("test_find_eig_cyclic")
+{
+    /*
+    Checks that the cyclic Jacobi method finds the analytical eigenvalues, that
+    the eigenvectors are orthonormal, and that A r = lambda r, for an even and
+    an odd dimension.
+    */
+
+    for (int n : {20, 21})
+    {
+        double step     = 1.0/n;
+        double diag     = 2/(step*step);            // diagonal elements
+        double off_diag = -1/(step*step);           // off-diagonal elements
+        double tol_off_diag = std::pow(10, -10);    // tolerance of off-diagonal norm
+        double tol_eig  = std::pow(10, -8);         // relative tolerance
+
+        arma::mat A = construct_diag_matrix(n, off_diag, diag);
+        arma::mat A_original = A;
+
+        arma::mat R = find_eig_cyclic(n, A, tol_off_diag);
+
+        REQUIRE(off_diag_norm(n, A) < tol_off_diag);
+
+        arma::vec sorted_diag = arma::sort(A.diag(0));
+
+        for (int i = 1; i <= n; i++)
+        {   // comparing with the analytical eigenvalues
+            double exact = diag + 2*off_diag*std::cos(i*pi/(n + 1));
+            REQUIRE(fabs(exact - sorted_diag(i - 1))/fabs(diag) < tol_eig);
+        }
+
+        for (int i = 0; i < n; i++)
+        {
+            arma::vec r_i = R.col(i);
+            
+            for (int j = 0; j < n; j++)
+            {   // orthonormality
+                arma::vec r_j = R.col(j);
+                double expected = (i == j) ? 1 : 0;
+                REQUIRE(fabs(arma::dot(r_i, r_j) - expected) < tol_eig);
+            }
+
+            for (int row = 0; row < n; row++)
+            {   // (A r)_row = lambda r_row
+                double a_r = 0;
+                for (int col = 0; col < n; col++)
+                {
+                    a_r += A_original(row, col)*r_i(col);
+                }
+                REQUIRE(fabs(a_r - A(i, i)*r_i(row))/fabs(diag) < tol_eig);
+            }
+        }
+    }
+}
+
+
+TEST_CASE("test_transform_lower_matches_transform")
+{
+    /*
+    Checks that transform_lower gives exactly the same lower triangle of A and
+    the same R as transform, for a sequence of rotations of a symmetric matrix.
+    */
+
+    int n = 17;                 // dimension of matrix
+    
+    arma::mat A(n, n);
+    arma::mat R(n, n);
+    R.zeros();
+    R.diag(0) += 1;
+
+    for (int i = 0; i < n; i++)
+    {   // populating a symmetric matrix with arbitrary values
+        for (int j = 0; j <= i; j++)
+        {
+            A(i, j) = A(j, i) = std::cos(2.0 + 5*i + 3*j*j);
+        }
+    }
+
+    arma::mat A_lower = A;
+    arma::mat R_lower = R;
+
+    for (int r = 0; r < 50; r++)
+    {   // rotating in arbitrary planes, both orderings of the indices
+        int k = (7*r + 1) % n;
+        int l = (3*r + 5) % n;
+        if (k == l) continue;
+
+        transform(n, A, R, k, l);
+        transform_lower(n, A_lower, R_lower, k, l);
+    }
+
+    for (int i = 0; i < n; i++)
+    {
+        for (int j = 0; j < n; j++)
+        {
+            if (j <= i)
+            {
+                REQUIRE(A(i, j) == A_lower(i, j));
+            }
+            REQUIRE(R(i, j) == R_lower(i, j));
+        }
+    }
+}
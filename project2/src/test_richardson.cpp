@@ -0,0 +1,80 @@
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+#include "richardson.h"
+#include "eigen_solver.h"
+
+
+TEST_CASE("test_richardson_polynomial")
+{
+    /*
+    Checks that a polynomial error of degree m in h^power is removed exactly
+    by m + 1 levels, also for step sizes which are not geometric.
+    */
+
+    double h[4] = {0.1, 0.05, 0.03, 0.02};
+
+    for (int power : {1, 2})
+    {
+        RichardsonExtrapolation extrapolation(power);
+
+        for (int i = 0; i < 4; i++)
+        {
+            double x = std::pow(h[i], power);
+            arma::vec values(2);
+            values(0) = 2 + 3*x + 5*x*x - x*x*x;
+            values(1) = -1 + x;
+            extrapolation.add(h[i], values);
+        }
+
+        REQUIRE(extrapolation.levels() == 4);
+        REQUIRE(fabs(extrapolation.extrapolated()(0) - 2) < 1e-10);
+        REQUIRE(fabs(extrapolation.extrapolated()(1) + 1) < 1e-12);
+        REQUIRE(extrapolation.error_estimate()(0) < 1e-3);
+        REQUIRE(extrapolation.converged(1e-3));
+    }
+}
+
+TEST_CASE("test_richardson_harmonic_oscillator")
+{
+    /*
+    Checks that the extrapolated eigenvalues of the grid in quantum_dots.cpp,
+    whose error is O(h), reach the analytical eigenvalues 3, 7, 11, 15 from
+    grids of at most 3200 points, and that the error estimate bounds the
+    error.
+    */
+
+    double rho_max = 8;
+    int num_eig    = 4;
+    double tol     = std::pow(10, -9);
+
+    RichardsonExtrapolation extrapolation;
+    std::unique_ptr<EigenSolver> solver = make_eigen_solver("lapack");
+    int grid = 50;
+
+    while (!extrapolation.converged(tol))
+    {
+        REQUIRE(grid <= 3200);
+
+        double step = rho_max/grid;
+        arma::vec diag_elements(grid);
+        arma::vec off_diag_elements(grid - 1);
+        off_diag_elements.fill(-1/(step*step));
+        for (int i = 0; i < grid; i++)
+        {   // inner boundary at -step, as in quantum_dots.cpp with rho_min = 0
+            diag_elements(i) = 2/(step*step) + (i*step)*(i*step);
+        }
+
+        extrapolation.add(step, solver->solve(grid, diag_elements,
+            off_diag_elements, num_eig));
+        grid *= 2;
+    }
+
+    arma::vec eigenvalues = extrapolation.extrapolated();
+    arma::vec error       = extrapolation.error_estimate();
+
+    for (int j = 0; j < num_eig; j++)
+    {
+        REQUIRE(fabs(eigenvalues(j) - (3 + 4*j)) < 1e-7);
+        REQUIRE(error(j) < tol*(3 + 4*j));
+    }
+}
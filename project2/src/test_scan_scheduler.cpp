@@ -0,0 +1,100 @@
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+#include "scan_scheduler.h"
+
+
+TEST_CASE("test_scan_scheduler_tasks")
+{
+    /*
+    Checks that the scans are expanded into the same rho_max values as the
+    loop in compute_and_write_eigendata, and that the tasks cover every point
+    once, do not mix scans, and are sorted by decreasing cost.
+    */
+
+    ScanScheduler scheduler;
+    scheduler.set_chunk(4);
+    scheduler.add_scan(0.25, 7.7, 10, 0.2, 100, "a");
+    scheduler.add_scan(1, 4.5, 5, 0.025, 400, "b");
+
+    int num_points = 0;
+    for (double rho_max = 7.7; rho_max <= 10; rho_max = rho_max + 0.2) num_points++;
+    for (double rho_max = 4.5; rho_max <= 5; rho_max = rho_max + 0.025) num_points++;
+    REQUIRE(scheduler.number_of_points() == num_points);
+
+    std::vector<ScanTask> tasks = scheduler.make_tasks();
+    std::vector<int> covered(num_points, 0);
+
+    for (int t = 0; t < (int) tasks.size(); t++)
+    {
+        REQUIRE(tasks[t].count <= 4);
+        if (t > 0) REQUIRE(tasks[t].cost <= tasks[t - 1].cost);
+
+        for (int i = tasks[t].first; i < tasks[t].first + tasks[t].count; i++)
+        {
+            REQUIRE(scheduler.point(i).scan == scheduler.point(tasks[t].first).scan);
+            covered[i]++;
+        }
+    }
+
+    for (int i = 0; i < num_points; i++)
+    {
+        REQUIRE(covered[i] == 1);
+    }
+}
+
+TEST_CASE("test_scan_scheduler_results")
+{
+    /*
+    Checks that the scheduled ground states agree with dstevr on every point,
+    and that the results do not depend on the number of threads.
+    */
+
+    double rho_min = 1e-7;
+    double tol     = std::pow(10, -8);
+
+    ScanScheduler scheduler;
+    scheduler.set_progress(false);
+    scheduler.set_chunk(3);
+    scheduler.add_scan(0.25, 7.7, 9, 0.2, 200, "a");
+    scheduler.add_scan(0.5, 5.5, 6, 0.05, 300, "b");
+
+    #ifdef _OPENMP
+        int max_threads = omp_get_max_threads();
+        omp_set_num_threads(1);
+    #endif
+    scheduler.run();
+
+    int num_points = scheduler.number_of_points();
+    std::vector<double> eigenvalues_serial(num_points);
+    for (int i = 0; i < num_points; i++)
+    {
+        eigenvalues_serial[i] = scheduler.eigenvalue(i);
+    }
+
+    #ifdef _OPENMP
+        omp_set_num_threads(4);
+    #endif
+    scheduler.run();
+    #ifdef _OPENMP
+        omp_set_num_threads(max_threads);
+    #endif
+
+    std::unique_ptr<EigenSolver> lapack = make_eigen_solver("lapack");
+
+    for (int i = 0; i < num_points; i++)
+    {
+        const ScanPoint& p = scheduler.point(i);
+        CoulombHamiltonian H(p.grid, rho_min, p.rho_max, p.freq);
+        arma::vec diag_elements = H.diagonal();
+        arma::vec off_diag_elements = H.off_diagonal();
+
+        arma::mat R;
+        arma::vec eigenvalues = lapack->solve(p.grid, diag_elements,
+            off_diag_elements, 1, &R);
+        arma::vec r = R.col(0);
+
+        REQUIRE(scheduler.eigenvalue(i) == eigenvalues_serial[i]);
+        REQUIRE(fabs(scheduler.eigenvalue(i) - eigenvalues(0)) < tol);
+        REQUIRE(fabs(arma::dot(scheduler.ground_state(i), r) - 1) < tol);
+    }
+}
@@ -0,0 +1,204 @@
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+#include "jacobi.h"
+#include "tridiagonal_eig.h"
+
+
+TEST_CASE("test_tridiagonal_eigenvalues")
+{
+    /*
+    Checks that the QL algorithm finds the analytical eigenvalues of the
+    (off_diag, diag, off_diag) Toeplitz matrix, in ascending order.
+    */
+
+    int n = 50;                                 // dimension of matrix
+    double step     = 1.0/n;
+    double diag     = 2/(step*step);            // diagonal elements
+    double off_diag = -1/(step*step);           // off-diagonal elements
+    double tol_eig  = std::pow(10, -8);         // tolerance of eigenvalues
+
+    arma::vec diag_elements(n);
+    diag_elements.fill(diag);
+
+    arma::vec eigenvalues = tridiagonal_eigenvalues(n, diag_elements, off_diag);
+
+    for (int i = 1; i <= n; i++)
+    {   // comparing with the analytical eigenvalues, relative to the largest
+        double exact = diag + 2*off_diag*std::cos(i*pi/(n + 1));
+        REQUIRE(fabs(exact - eigenvalues(i - 1))/fabs(diag) < tol_eig);
+    }
+}
+
+TEST_CASE("test_tridiagonal_eig_matches_jacobi")
+{
+    /*
+    Checks that QL with accumulated eigenvectors gives the same eigenpairs as
+    find_eig for a matrix with a varying diagonal, and that the eigenvectors
+    are orthonormal.
+    */
+
+    int n = 20;                                 // dimension of matrix
+    double step     = 5.0/n;
+    double off_diag = -1/(step*step);
+    double tol_off_diag = std::pow(10, -12);    // tolerance for Jacobi
+    double tol_eig  = std::pow(10, -8);
+
+    arma::vec diag_elements(n);
+    for (int i = 0; i < n; i++)
+    {   // harmonic oscillator potential
+        diag_elements(i) = 2/(step*step) + (i*step)*(i*step);
+    }
+
+    arma::vec eigenvalues;
+    arma::mat R = tridiagonal_eig(n, diag_elements, off_diag, eigenvalues);
+
+    arma::mat A = construct_diag_matrix(n, off_diag, diag_elements);
+    arma::mat R_jacobi = find_eig(n, A, tol_off_diag);
+    arma::uvec order = arma::sort_index(A.diag(0));
+
+    for (int i = 0; i < n; i++)
+    {
+        REQUIRE(fabs(eigenvalues(i) - A(order(i), order(i))) < tol_eig*fabs(eigenvalues(n-1)));
+
+        // eigenvectors are equal up to the sign
+        arma::vec r_jacobi = R_jacobi.col(order(i));
+        arma::vec r_i = R.col(i);
+        REQUIRE(fabs(fabs(arma::dot(r_i, r_jacobi)) - 1) < tol_eig);
+
+        for (int j = 0; j < n; j++)
+        {   // orthonormality
+            arma::vec r_j = R.col(j);
+            double expected = (i == j) ? 1 : 0;
+            REQUIRE(fabs(arma::dot(r_i, r_j) - expected) < tol_eig);
+        }
+    }
+}
+
+TEST_CASE("test_inverse_iteration")
+{
+    /*
+    Checks that inverse iteration finds the eigenvectors of the lowest
+    eigenvalues, i.e., that the residual |T r - lambda r| is small and that
+    they agree with the QL eigenvectors.
+    */
+
+    int n = 200;                                // dimension of matrix
+    int k = 4;                                  // number of eigenvectors
+    double step     = 5.0/n;
+    double off_diag = -1/(step*step);
+    double tol      = std::pow(10, -8);
+
+    arma::vec diag_elements(n);
+    for (int i = 0; i < n; i++)
+    {   // harmonic oscillator potential
+        diag_elements(i) = 2/(step*step) + ((i + 1)*step)*((i + 1)*step);
+    }
+
+    arma::vec all_eigenvalues;
+    arma::mat R_ql = tridiagonal_eig(n, diag_elements, off_diag, all_eigenvalues);
+
+    arma::vec lowest(k);
+    for (int j = 0; j < k; j++)
+    {
+        lowest(j) = all_eigenvalues(j);
+    }
+
+    arma::mat R = inverse_iteration(n, diag_elements, off_diag, lowest);
+
+    for (int j = 0; j < k; j++)
+    {
+        double residual = 0;
+        for (int i = 0; i < n; i++)
+        {   // (T r)_i - lambda r_i
+            double t_r = diag_elements(i)*R(i, j);
+            if (i > 0)     t_r += off_diag*R(i - 1, j);
+            if (i < n - 1) t_r += off_diag*R(i + 1, j);
+            residual = std::max(residual, fabs(t_r - lowest(j)*R(i, j)));
+        }
+        REQUIRE(residual < tol*fabs(all_eigenvalues(n - 1)));
+
+        arma::vec r_j  = R.col(j);
+        arma::vec r_ql = R_ql.col(j);
+        REQUIRE(fabs(fabs(arma::dot(r_j, r_ql)) - 1) < tol);
+    }
+}
+
+TEST_CASE("test_sturm_count_and_rayleigh_quotient_iteration")
+{
+    /*
+    Checks that sturm_count counts the eigenvalues below a point, and that
+    Rayleigh quotient iteration from a perturbed eigenvector converges to the
+    QL eigenpair in a few iterations.
+    */
+
+    int n = 200;                                // dimension of matrix
+    double step     = 5.0/n;
+    double off_diag = -1/(step*step);
+    double tol      = std::pow(10, -8);
+
+    arma::vec diag_elements(n);
+    arma::vec off_diag_elements(n - 1);
+    off_diag_elements.fill(off_diag);
+    for (int i = 0; i < n; i++)
+    {   // harmonic oscillator potential
+        diag_elements(i) = 2/(step*step) + ((i + 1)*step)*((i + 1)*step);
+    }
+
+    arma::vec eigenvalues;
+    arma::mat R = tridiagonal_eig(n, diag_elements, off_diag, eigenvalues);
+    arma::uvec order = arma::sort_index(eigenvalues);
+
+    REQUIRE(sturm_count(n, diag_elements, off_diag_elements, eigenvalues(order(0)) - 1) == 0);
+    for (int j = 0; j < 5; j++)
+    {   // halfway between eigenvalue j and j + 1
+        double x = 0.5*(eigenvalues(order(j)) + eigenvalues(order(j + 1)));
+        REQUIRE(sturm_count(n, diag_elements, off_diag_elements, x) == j + 1);
+    }
+
+    for (int j = 0; j < 3; j++)
+    {
+        arma::vec x(n);
+        for (int i = 0; i < n; i++)
+        {   // eigenvector with a smooth perturbation
+            x(i) = R(i, order(j)) + 0.05*std::sin(pi*(i + 1)/(n + 1));
+        }
+
+        double eigenvalue;
+        int iterations = rayleigh_quotient_iteration(n, diag_elements,
+            off_diag_elements, x, eigenvalue);
+
+        REQUIRE(iterations >= 0);
+        REQUIRE(iterations <= 4);
+        REQUIRE(fabs(eigenvalue - eigenvalues(order(j))) < tol);
+
+        arma::vec r = R.col(order(j));
+        REQUIRE(fabs(fabs(arma::dot(x, r)) - 1) < tol);
+    }
+}
+
+TEST_CASE("test_tridiagonal_ql_no_convergence")
+{
+    /*
+    Checks that tridiagonal_ql returns false, and the wrappers throw, when
+    the iteration does not converge. A NaN on the diagonal never lets the
+    matrix split.
+    */
+
+    int n = 10;                                 // dimension of matrix
+
+    arma::vec diag_elements(n);
+    arma::vec off_diag_elements(n);
+    diag_elements.fill(2);
+    off_diag_elements.fill(-1);
+    diag_elements(0) = std::numeric_limits<double>::quiet_NaN();
+
+    arma::vec values = diag_elements;
+    arma::vec work = off_diag_elements;
+    REQUIRE(!tridiagonal_ql(n, values.memptr(), work.memptr(), nullptr));
+
+    arma::vec eigenvalues;
+    REQUIRE_THROWS_AS(tridiagonal_eigenvalues(n, diag_elements, off_diag_elements),
+        std::runtime_error);
+    REQUIRE_THROWS_AS(tridiagonal_eig(n, diag_elements, off_diag_elements, eigenvalues),
+        std::runtime_error);
+}
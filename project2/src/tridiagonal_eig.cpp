@@ -0,0 +1,644 @@
+#include "tridiagonal_eig.h"
+
+
+bool tridiagonal_ql(int n, double* diag, double* off_diag, double* Z)
+{
+    /*
+    Implicit QL algorithm with Wilkinson shifts for a symmetric tridiagonal
+    matrix. Works directly on the diagonal and off-diagonal, and costs O(n^2)
+    for the eigenvalues, plus O(n^3) if the eigenvectors are accumulated in Z,
+    which is still far less than Jacobi rotations on the dense matrix.
+
+    The eigenvalues are not sorted.
+
+    Parameters
+    ----------
+    n : int
+        Dimension of matrix.
+
+    diag : double*
+        Diagonal elements, n values. Overwritten with the eigenvalues.
+
+    off_diag : double*
+        Off-diagonal elements, off_diag[i] is element (i, i+1). Must have room
+        for n values, the last one is used as workspace. Overwritten.
+
+    Z : double*
+        Column-major n x n matrix, usually the identity, which the rotations
+        are applied to. Column i then holds the eigenvector of diag[i]. May be
+        nullptr if only the eigenvalues are needed.
+
+    Returns
+    -------
+    converged : bool
+        False if an eigenvalue did not converge within 30 iterations.
+    */
+
+    const double eps  = std::numeric_limits<double>::epsilon();
+    const int max_iterations = 30;
+
+    off_diag[n-1] = 0;
+
+    for (int l=0; l<n; l++)
+    {   // finding eigenvalue l
+        int iterations = 0;
+        int m;
+
+        do
+        {
+            for (m=l; m<n-1; m++)
+            {   // looking for a small off-diagonal element to split the matrix
+                double dd = std::fabs(diag[m]) + std::fabs(diag[m+1]);
+                if (std::fabs(off_diag[m]) <= eps*dd) break;
+            }
+
+            if (m != l)
+            {
+                if (iterations++ == max_iterations)
+                {
+                    return false;
+                }
+
+                // Wilkinson shift from the leading 2x2 block
+                double g = (diag[l+1] - diag[l])/(2*off_diag[l]);
+                double r = std::hypot(g, 1.0);
+                g = diag[m] - diag[l] + off_diag[l]/(g + std::copysign(r, g));
+
+                double s = 1;
+                double c = 1;
+                double p = 0;
+                int i;
+
+                for (i=m-1; i>=l; i--)
+                {   // plane rotations chasing the bulge up to row l
+                    double f = s*off_diag[i];
+                    double b = c*off_diag[i];
+                    r = std::hypot(f, g);
+                    off_diag[i+1] = r;
+
+                    if (r == 0)
+                    {   // underflow, the matrix splits
+                        diag[i+1] -= p;
+                        off_diag[m] = 0;
+                        break;
+                    }
+
+                    s = f/r;
+                    c = g/r;
+                    g = diag[i+1] - p;
+                    r = (diag[i] - g)*s + 2*c*b;
+                    p = s*r;
+                    diag[i+1] = g + p;
+                    g = c*r - b;
+
+                    if (Z != nullptr)
+                    {   // accumulating the rotation in columns i and i+1
+                        double* z_i  = Z + (long)i*n;
+                        double* z_i1 = Z + (long)(i+1)*n;
+
+                        for (int k=0; k<n; k++)
+                        {
+                            f       = z_i1[k];
+                            z_i1[k] = s*z_i[k] + c*f;
+                            z_i[k]  = c*z_i[k] - s*f;
+                        }
+                    }
+                }
+
+                if ((r == 0) && (i >= l)) continue;
+
+                diag[l] -= p;
+                off_diag[l] = g;
+                off_diag[m] = 0;
+            }
+        } while (m != l);
+    }
+
+    return true;
+}
+
+
+arma::vec tridiagonal_eigenvalues(int n, const arma::vec& diag, const arma::vec& off_diag)
+{
+    /*
+    Eigenvalues of a symmetric tridiagonal matrix by the implicit QL
+    algorithm, O(n^2).
+
+    Parameters
+    ----------
+    n : int
+        Dimension of matrix.
+
+    diag : const arma::vec&
+        Diagonal elements, n values.
+
+    off_diag : const arma::vec&
+        Off-diagonal elements, n-1 values.
+
+    Returns
+    -------
+    eigenvalues : arma::vec
+        The eigenvalues in ascending order.
+
+    Throws std::runtime_error if the QL iteration does not converge.
+    */
+
+    arma::vec eigenvalues = diag;
+    arma::vec work(n);
+
+    for (int i=0; i<n-1; i++)
+    {
+        work(i) = off_diag(i);
+    }
+
+    if (!tridiagonal_ql(n, eigenvalues.memptr(), work.memptr(), nullptr))
+    {
+        throw std::runtime_error("tridiagonal_ql: no convergence");
+    }
+
+    return arma::sort(eigenvalues);
+}
+
+
+arma::vec tridiagonal_eigenvalues(int n, const arma::vec& diag, double off_diag)
+{
+    /*
+    Overloaded function for a constant off-diagonal, as produced by
+    construct_diag_matrix.
+    */
+
+    arma::vec off(n);
+    off.fill(off_diag);
+
+    return tridiagonal_eigenvalues(n, diag, off);
+}
+
+
+arma::mat tridiagonal_eig(int n, const arma::vec& diag, const arma::vec& off_diag,
+    arma::vec& eigenvalues)
+{
+    /*
+    All eigenvalues and eigenvectors of a symmetric tridiagonal matrix by the
+    implicit QL algorithm. Use inverse_iteration instead when only a few
+    eigenvectors are needed.
+
+    Parameters
+    ----------
+    n : int
+        Dimension of matrix.
+
+    diag : const arma::vec&
+        Diagonal elements, n values.
+
+    off_diag : const arma::vec&
+        Off-diagonal elements, n-1 values.
+
+    eigenvalues : arma::vec&
+        Reference to vector where the eigenvalues are stored in ascending
+        order.
+
+    Returns
+    -------
+    R : arma::mat
+        Normalized eigenvectors, column i belongs to eigenvalues(i).
+
+    Throws std::runtime_error if the QL iteration does not converge.
+    */
+
+    arma::vec values = diag;
+    arma::vec work(n);
+    arma::mat Z(n, n);
+    Z.zeros();
+    Z.diag(0) += 1;
+
+    for (int i=0; i<n-1; i++)
+    {
+        work(i) = off_diag(i);
+    }
+
+    if (!tridiagonal_ql(n, values.memptr(), work.memptr(), Z.memptr()))
+    {
+        throw std::runtime_error("tridiagonal_ql: no convergence");
+    }
+
+    arma::uvec order = arma::sort_index(values);
+    arma::mat R(n, n);
+    eigenvalues.set_size(n);
+
+    for (int j=0; j<n; j++)
+    {   // sorting eigenpairs by eigenvalue
+        eigenvalues(j) = values(order(j));
+        for (int i=0; i<n; i++)
+        {
+            R(i, j) = Z(i, order(j));
+        }
+    }
+
+    return R;
+}
+
+
+arma::mat tridiagonal_eig(int n, const arma::vec& diag, double off_diag,
+    arma::vec& eigenvalues)
+{
+    /*
+    Overloaded function for a constant off-diagonal, as produced by
+    construct_diag_matrix.
+    */
+
+    arma::vec off(n);
+    off.fill(off_diag);
+
+    return tridiagonal_eig(n, diag, off, eigenvalues);
+}
+
+
+struct ShiftedLU
+{
+    /*
+    LU factorization with partial pivoting of T - shift*I for a symmetric
+    tridiagonal T, as in LAPACK dgttrf. U has two super-diagonals.
+    */
+    std::vector<double> dl, d, du, du2;
+    std::vector<bool> swapped;
+
+    ShiftedLU(int n) : dl(n), d(n), du(n), du2(n), swapped(n) {}
+};
+
+
+static void factorize_shifted(int n, const arma::vec& diag, const arma::vec& off_diag,
+    double shift, double tiny, ShiftedLU& lu)
+{
+    /*
+    Factorizes T - shift*I. Pivots smaller than tiny, where the shifted
+    matrix is singular to working precision, are replaced by +-tiny, which is
+    what inverse iteration needs.
+    */
+
+    std::vector<double>& dl  = lu.dl;
+    std::vector<double>& d   = lu.d;
+    std::vector<double>& du  = lu.du;
+    std::vector<double>& du2 = lu.du2;
+
+    for (int i=0; i<n; i++)
+    {   // T - shift*I
+        d[i] = diag(i) - shift;
+        if (i < n-1)
+        {
+            dl[i] = off_diag(i);
+            du[i] = off_diag(i);
+        }
+    }
+
+    for (int i=0; i<n-1; i++)
+    {   // LU factorization with partial pivoting, U has two super-diagonals
+        if (std::fabs(d[i]) >= std::fabs(dl[i]))
+        {
+            lu.swapped[i] = false;
+            double fact = (d[i] != 0) ? dl[i]/d[i] : 0;
+            dl[i]   = fact;
+            d[i+1] -= fact*du[i];
+            du2[i]  = 0;
+        }
+        else
+        {   // interchanging rows i and i+1
+            lu.swapped[i] = true;
+            double fact = d[i]/dl[i];
+            double temp = du[i];
+            d[i]   = dl[i];
+            dl[i]  = fact;
+            du[i]  = d[i+1];
+            d[i+1] = temp - fact*d[i+1];
+
+            if (i < n-2)
+            {
+                du2[i]  = du[i+1];
+                du[i+1] = -fact*du[i+1];
+            }
+            else
+            {
+                du2[i] = 0;
+            }
+        }
+    }
+
+    for (int i=0; i<n; i++)
+    {   // the shifted matrix is singular to working precision
+        if (std::fabs(d[i]) < tiny)
+        {
+            d[i] = (d[i] < 0) ? -tiny : tiny;
+        }
+    }
+}
+
+
+static void solve_shifted(int n, const ShiftedLU& lu, std::vector<double>& x)
+{
+    /*
+    Solves (T - shift*I) y = x with the factors from factorize_shifted, and
+    stores y in x.
+    */
+
+    const std::vector<double>& dl  = lu.dl;
+    const std::vector<double>& d   = lu.d;
+    const std::vector<double>& du  = lu.du;
+    const std::vector<double>& du2 = lu.du2;
+
+    for (int i=0; i<n-1; i++)
+    {   // solving L y = P x
+        if (lu.swapped[i])
+        {
+            double temp = x[i];
+            x[i]   = x[i+1];
+            x[i+1] = temp - dl[i]*x[i];
+        }
+        else
+        {
+            x[i+1] -= dl[i]*x[i];
+        }
+    }
+
+    x[n-1] /= d[n-1];
+    if (n > 1) x[n-2] = (x[n-2] - du[n-2]*x[n-1])/d[n-2];
+    for (int i=n-3; i>=0; i--)
+    {   // solving U x = y
+        x[i] = (x[i] - du[i]*x[i+1] - du2[i]*x[i+2])/d[i];
+    }
+}
+
+
+arma::mat inverse_iteration(int n, const arma::vec& diag, const arma::vec& off_diag,
+    const arma::vec& eigenvalues, int iterations)
+{
+    /*
+    Eigenvectors of a symmetric tridiagonal matrix T for a set of known
+    eigenvalues, e.g., the lowest few from tridiagonal_eigenvalues. For each
+    eigenvalue, T - lambda*I is factorized by Gaussian elimination with
+    partial pivoting, and a few solves with it turn a start vector into the
+    eigenvector. Each vector costs O(n), so k vectors cost O(kn) instead of the
+    O(n^3) of accumulating all of them.
+
+    Vectors of eigenvalues closer than 1e-3*|T| are orthogonalized against each
+    other. The sign is chosen such that the largest component is positive.
+
+    Parameters
+    ----------
+    n : int
+        Dimension of matrix.
+
+    diag : const arma::vec&
+        Diagonal elements, n values.
+
+    off_diag : const arma::vec&
+        Off-diagonal elements, n-1 values.
+
+    eigenvalues : const arma::vec&
+        Eigenvalues to find eigenvectors for.
+
+    iterations : int
+        Number of solves per eigenvector. Defaults to 3.
+
+    Returns
+    -------
+    R : arma::mat
+        Normalized eigenvectors, column j belongs to eigenvalues(j).
+    */
+
+    int k = eigenvalues.n_elem;
+    arma::mat R(n, k);
+
+    double norm_T = 0;
+    for (int i=0; i<n; i++)
+    {   // infinity norm of T, for the cluster limit and the zero pivots
+        double row = std::fabs(diag(i));
+        if (i > 0)   row += std::fabs(off_diag(i-1));
+        if (i < n-1) row += std::fabs(off_diag(i));
+        norm_T = std::max(norm_T, row);
+    }
+    double tiny    = std::numeric_limits<double>::epsilon()*norm_T;
+    double cluster = 1e-3*norm_T;
+
+    ShiftedLU factors(n);
+    std::vector<double> x(n);
+
+    for (int j=0; j<k; j++)
+    {   // one eigenvector at a time
+        double lambda = eigenvalues(j);
+
+        factorize_shifted(n, diag, off_diag, lambda, tiny, factors);
+
+        unsigned int seed = 12345 + j;
+        for (int i=0; i<n; i++)
+        {   // pseudo-random start vector, not orthogonal to any eigenvector
+            seed = 1103515245u*seed + 12345u;
+            x[i] = 0.5 + (seed >> 16)/65536.0;
+        }
+
+        for (int it=0; it<iterations; it++)
+        {
+            solve_shifted(n, factors, x);
+
+            for (int p=0; p<j; p++)
+            {   // orthogonalizing against vectors of close eigenvalues
+                if (std::fabs(eigenvalues(p) - lambda) < cluster)
+                {
+                    double proj = 0;
+                    for (int i=0; i<n; i++) proj += R(i, p)*x[i];
+                    for (int i=0; i<n; i++) x[i] -= proj*R(i, p);
+                }
+            }
+
+            double norm = 0;
+            for (int i=0; i<n; i++) norm += x[i]*x[i];
+            norm = std::sqrt(norm);
+            for (int i=0; i<n; i++) x[i] /= norm;
+        }
+
+        int largest = 0;
+        for (int i=1; i<n; i++)
+        {
+            if (std::fabs(x[i]) > std::fabs(x[largest])) largest = i;
+        }
+        double sign = (x[largest] < 0) ? -1 : 1;
+
+        for (int i=0; i<n; i++)
+        {
+            R(i, j) = sign*x[i];
+        }
+    }
+
+    return R;
+}
+
+
+arma::mat inverse_iteration(int n, const arma::vec& diag, double off_diag,
+    const arma::vec& eigenvalues, int iterations)
+{
+    /*
+    Overloaded function for a constant off-diagonal, as produced by
+    construct_diag_matrix.
+    */
+
+    arma::vec off(n);
+    off.fill(off_diag);
+
+    return inverse_iteration(n, diag, off, eigenvalues, iterations);
+}
+
+
+int sturm_count(int n, const arma::vec& diag, const arma::vec& off_diag, double x)
+{
+    /*
+    Number of eigenvalues of a symmetric tridiagonal matrix T smaller than x,
+    which by Sylvester's law of inertia is the number of negative pivots of
+    the LDL^T factorization of T - x*I. Costs O(n).
+
+    Parameters
+    ----------
+    n : int
+        Dimension of matrix.
+
+    diag : const arma::vec&
+        Diagonal elements, n values.
+
+    off_diag : const arma::vec&
+        Off-diagonal elements, n-1 values.
+
+    x : double
+        Where to count.
+    */
+
+    double tiny = std::numeric_limits<double>::min();
+    int count = 0;
+    double pivot = diag(0) - x;
+
+    for (int i=0; i<n; i++)
+    {
+        if (i > 0)
+        {
+            pivot = diag(i) - x - off_diag(i-1)*off_diag(i-1)/pivot;
+        }
+        if (pivot == 0)
+        {   // x is an eigenvalue of the leading submatrix
+            pivot = -tiny;
+        }
+        if (pivot < 0)
+        {
+            count++;
+        }
+    }
+
+    return count;
+}
+
+
+int rayleigh_quotient_iteration(int n, const arma::vec& diag, const arma::vec& off_diag,
+    arma::vec& vector, double& eigenvalue, double tol, int max_iterations)
+{
+    /*
+    Refines an approximate eigenvector of a symmetric tridiagonal matrix T by
+    Rayleigh quotient iteration. The shift is the Rayleigh quotient of the
+    current vector, and every iteration is one O(n) solve with T - shift*I as
+    in inverse_iteration. Convergence is cubic, so a good start vector, e.g.,
+    the eigenvector of a slightly different matrix, needs two or three
+    iterations.
+
+    The iteration converges to the eigenpair closest to the start, which is
+    not necessarily the wanted one. Use sturm_count to check which eigenvalue
+    was found.
+
+    Parameters
+    ----------
+    n : int
+        Dimension of matrix.
+
+    diag : const arma::vec&
+        Diagonal elements, n values.
+
+    off_diag : const arma::vec&
+        Off-diagonal elements, n-1 values.
+
+    vector : arma::vec&
+        Start vector in, normalized eigenvector out. The sign is chosen such
+        that the largest component is positive.
+
+    eigenvalue : double&
+        The Rayleigh quotient of vector out.
+
+    tol : double
+        Convergence when |T x - eigenvalue*x| < tol*|T|. Defaults to 1e-13.
+
+    max_iterations : int
+        Largest number of solves. Defaults to 10.
+
+    Returns
+    -------
+    iterations : int
+        Number of solves, or -1 if the iteration did not converge.
+    */
+
+    double norm_T = 0;
+    for (int i=0; i<n; i++)
+    {   // infinity norm of T, for the residual and the zero pivots
+        double row = std::fabs(diag(i));
+        if (i > 0)   row += std::fabs(off_diag(i-1));
+        if (i < n-1) row += std::fabs(off_diag(i));
+        norm_T = std::max(norm_T, row);
+    }
+    double tiny = std::numeric_limits<double>::epsilon()*norm_T;
+
+    ShiftedLU factors(n);
+    std::vector<double> x(vector.begin(), vector.end());
+    std::vector<double> t_x(n);
+    int iterations = -1;
+
+    for (int it=0; it<=max_iterations; it++)
+    {
+        double norm = 0;
+        for (int i=0; i<n; i++) norm += x[i]*x[i];
+        norm = std::sqrt(norm);
+        for (int i=0; i<n; i++) x[i] /= norm;
+
+        double quotient = 0;
+        for (int i=0; i<n; i++)
+        {   // T x and the Rayleigh quotient x^T T x
+            t_x[i] = diag(i)*x[i];
+            if (i > 0)   t_x[i] += off_diag(i-1)*x[i-1];
+            if (i < n-1) t_x[i] += off_diag(i)*x[i+1];
+            quotient += x[i]*t_x[i];
+        }
+        eigenvalue = quotient;
+
+        double residual = 0;
+        for (int i=0; i<n; i++)
+        {
+            double r = t_x[i] - quotient*x[i];
+            residual += r*r;
+        }
+
+        if (std::sqrt(residual) < tol*norm_T)
+        {
+            iterations = it;
+            break;
+        }
+        if (it == max_iterations) break;
+
+        factorize_shifted(n, diag, off_diag, quotient, tiny, factors);
+        solve_shifted(n, factors, x);
+    }
+
+    int largest = 0;
+    for (int i=1; i<n; i++)
+    {
+        if (std::fabs(x[i]) > std::fabs(x[largest])) largest = i;
+    }
+    double sign = (x[largest] < 0) ? -1 : 1;
+
+    vector.set_size(n);
+    for (int i=0; i<n; i++)
+    {
+        vector(i) = sign*x[i];
+    }
+
+    return iterations;
+}
@@ -0,0 +1,28 @@
+#ifndef TRIDIAGONAL_EIG_H
+#define TRIDIAGONAL_EIG_H
+
+#include <armadillo>
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+
+bool tridiagonal_ql(int n, double* diag, double* off_diag, double* Z);
+arma::vec tridiagonal_eigenvalues(int n, const arma::vec& diag, const arma::vec& off_diag);
+arma::vec tridiagonal_eigenvalues(int n, const arma::vec& diag, double off_diag);
+arma::mat tridiagonal_eig(int n, const arma::vec& diag, const arma::vec& off_diag,
+    arma::vec& eigenvalues);
+arma::mat tridiagonal_eig(int n, const arma::vec& diag, double off_diag,
+    arma::vec& eigenvalues);
+arma::mat inverse_iteration(int n, const arma::vec& diag, const arma::vec& off_diag,
+    const arma::vec& eigenvalues, int iterations = 3);
+arma::mat inverse_iteration(int n, const arma::vec& diag, double off_diag,
+    const arma::vec& eigenvalues, int iterations = 3);
+int sturm_count(int n, const arma::vec& diag, const arma::vec& off_diag, double x);
+int rayleigh_quotient_iteration(int n, const arma::vec& diag, const arma::vec& off_diag,
+    arma::vec& vector, double& eigenvalue, double tol = 1e-13, int max_iterations = 10);
+
+#endif